@@ -60,7 +60,29 @@
 
 #define ICACHE_DATA_SIZE ( ICACHE_WAYS * ICACHE_LINE )
 #define ICACHE_TAGS_SIZE ( ICACHE_WAYS * ICACHE_TAG_WIDTH + 2 * ICACHE_WAYS) // Contais the tags and the valid/dirty bits
-#define ICACHE_BUFFER_SIZE ( ICACHE_LINE / ADDR_WIDTH  + 1)
+#define ICACHE_LINE_REUSE 1 // Fetches from the line of the previous fetch skip the I$ arrays
+
+#define ICACHE_WAY_PREDICTION 1 // Read only the predicted I$ way, one cycle penalty on a wrong prediction
+
+// Cache replacement policies
+#define REPL_LRU 0 // True LRU, log2(ways) age bits per way
+#define REPL_PLRU 1 // Tree pseudo-LRU, ways - 1 bits per set (ways must be a power of 2)
+#define REPL_FIFO 2 // Round-robin, log2(ways) bits per set
+#define REPL_RANDOM 3 // LFSR based, 16 bits per set
+#define REPL_SRRIP 4 // Static RRIP, REPL_RRPV_WIDTH bits per way
+
+#define REPL_RRPV_WIDTH 2 // Re-reference prediction value bits for REPL_SRRIP
+
+#define ICACHE_REPL_POLICY REPL_LRU
+#define DCACHE_REPL_POLICY REPL_LRU
+
+// Bits to address one of WAYS ways, ( (int) log2( WAYS ) ) rounded up and
+// at least 1, for up to 16 ways. The users check it against repl_way_width.
+#define WAYS_WIDTH(WAYS) ( (WAYS) > 8 ? 4 : (WAYS) > 4 ? 3 : (WAYS) > 2 ? 2 : 1 )
+
+#define ICACHE_WAYS_WIDTH WAYS_WIDTH(ICACHE_WAYS)
+#define DCACHE_WAYS_WIDTH WAYS_WIDTH(DCACHE_WAYS)
+
 // Dbg directives.
 
 #define INTERNAL_PROG // When on specifies the program to execute as an array in the fetch stage (not for production).
@@ -29,10 +29,10 @@ struct de_in_t {
     //
     // Member declarations.
     //
-    sc_uint < 1 > jump;
-    sc_uint < 1 > branch;
-    sc_uint < PC_LEN > jump_address;
-    sc_uint < PC_LEN > branch_address;
+    ac_int < 1, false > jump;
+    ac_int < 1, false > branch;
+    ac_int < PC_LEN, false > jump_address;
+    ac_int < PC_LEN, false > branch_address;
 
     static const int width = 2 + 2 * PC_LEN;
 
@@ -128,8 +128,8 @@ struct fe_out_t {
     //
     // Member declarations.
     //
-    sc_uint < PC_LEN > pc;
-    sc_uint < XLEN > instr_data;
+    ac_int < PC_LEN, false > pc;
+    ac_int < XLEN, false > instr_data;
 
     static const int width = PC_LEN + XLEN;
 
@@ -211,18 +211,18 @@ struct de_out_t {
     //
     // Member declarations.
     //
-    sc_uint < 1 > regwrite;
-    sc_uint < 1 > memtoreg;
-    sc_uint < 3 > ld;
-    sc_uint < 2 > st;
-    sc_uint < ALUOP_SIZE > alu_op;
-    sc_uint < ALUSRC_SIZE > alu_src;
-    sc_int < XLEN > rs1;
-    sc_int < XLEN > rs2;
-    sc_uint < REG_ADDR > dest_reg;
-    sc_uint < PC_LEN > pc;
-    sc_uint < XLEN - 12 > imm_u;
-    sc_uint < TAG_WIDTH > tag;
+    ac_int < 1, false > regwrite;
+    ac_int < 1, false > memtoreg;
+    ac_int < 3, false > ld;
+    ac_int < 2, false > st;
+    ac_int < ALUOP_SIZE, false > alu_op;
+    ac_int < ALUSRC_SIZE, false > alu_src;
+    ac_int < XLEN, true > rs1;
+    ac_int < XLEN, true > rs2;
+    ac_int < REG_ADDR, false > dest_reg;
+    ac_int < PC_LEN, false > pc;
+    ac_int < XLEN - 12, false > imm_u;
+    ac_int < TAG_WIDTH, false > tag;
 
     static
     const int width = 1 + 1 + 3 + 2 + ALUOP_SIZE + ALUSRC_SIZE + 3 * XLEN - 12 + REG_ADDR + PC_LEN + TAG_WIDTH;
@@ -387,15 +387,15 @@ struct exe_out_t // TODO: fix all sizes
     //
     // Member declarations.
     //
-    sc_uint < 3 > ld;
-    sc_uint < 2 > st;
-    sc_uint < 1 > memtoreg;
-    sc_uint < 1 > regwrite;
-    sc_uint < XLEN > alu_res;
-    sc_int < DATA_SIZE > mem_datain;
-    sc_uint < REG_ADDR > dest_reg;
-    sc_uint < TAG_WIDTH > tag;
-    sc_uint < PC_LEN > pc;
+    ac_int < 3, false > ld;
+    ac_int < 2, false > st;
+    ac_int < 1, false > memtoreg;
+    ac_int < 1, false > regwrite;
+    ac_int < XLEN, false > alu_res;
+    ac_int < DATA_SIZE, true > mem_datain;
+    ac_int < REG_ADDR, false > dest_reg;
+    ac_int < TAG_WIDTH, false > tag;
+    ac_int < PC_LEN, false > pc;
 
     static const int width = 3 + 2 + 1 + 1 + XLEN + DATA_SIZE + REG_ADDR + TAG_WIDTH + PC_LEN;
 
@@ -532,11 +532,11 @@ struct mem_out_t {
     //
     // Member declarations.
     //
-    sc_uint < 1 > regwrite;
-    sc_uint < REG_ADDR > regfile_address;
-    sc_int < XLEN > regfile_data;
-    sc_uint < TAG_WIDTH > tag;
-    sc_uint < PC_LEN > pc;
+    ac_int < 1, false > regwrite;
+    ac_int < REG_ADDR, false > regfile_address;
+    ac_int < XLEN, true > regfile_data;
+    ac_int < TAG_WIDTH, false > tag;
+    ac_int < PC_LEN, false > pc;
 
     static const int width = 1 + REG_ADDR + XLEN + TAG_WIDTH + PC_LEN;
     //
@@ -637,11 +637,11 @@ struct reg_forward_t {
     //
     // Member declarations.
     //
-    sc_int < XLEN > regfile_data;
+    ac_int < XLEN, true > regfile_data;
     bool ldst;
     bool sync_fewb;
-    sc_uint < TAG_WIDTH > tag;
-    sc_uint < PC_LEN > pc;
+    ac_int < TAG_WIDTH, false > tag;
+    ac_int < PC_LEN, false > pc;
 
     static
     const int width = XLEN + 1 + 1 + TAG_WIDTH + PC_LEN;
@@ -748,7 +748,7 @@ struct imem_in_t {
     //
     // Member declarations.
     //
-    sc_uint < XLEN > instr_addr;
+    ac_int < XLEN, false > instr_addr;
 
     static const int width = XLEN;
     //
@@ -816,7 +816,7 @@ struct imem_out_t {
     //
     // Member declarations.
     //
-    sc_uint < ICACHE_LINE > instr_data;
+    ac_int < ICACHE_LINE, false > instr_data;
 
     static const int width = ICACHE_LINE;
     //
@@ -885,9 +885,9 @@ struct dmem_in_t {
     //
     // Member declarations.
     //
-    sc_uint < XLEN > data_addr;
-    sc_uint < XLEN > write_addr;
-    sc_uint < DCACHE_LINE > data_in;
+    ac_int < XLEN, false > data_addr;
+    ac_int < XLEN, false > write_addr;
+    ac_int < DCACHE_LINE, false > data_in;
     bool read_en;
     bool write_en;
 
@@ -991,7 +991,7 @@ struct dmem_out_t {
     //
     // Member declarations.
     //
-    sc_uint < DCACHE_LINE > data_out;
+    ac_int < DCACHE_LINE, false > data_out;
 
     static const int width = DCACHE_LINE;
     //
@@ -1061,7 +1061,7 @@ struct fe_in_t {
     //
     bool freeze;
     bool redirect;
-    sc_uint < PC_LEN > address;
+    ac_int < PC_LEN, false > address;
 
     static const int width = 1 + 1 + PC_LEN;
     //
@@ -1146,7 +1146,7 @@ struct icache_data_t {
     //
     // Member declarations.
     //
-    sc_uint < ICACHE_LINE > data;
+    ac_int < ICACHE_LINE, false > data;
 
     static const int width = ICACHE_LINE;
     //
@@ -1214,7 +1214,7 @@ struct icache_tag_t {
     //
     // Member declarations.
     //
-    sc_uint < ICACHE_TAG_WIDTH > tag;
+    ac_int < ICACHE_TAG_WIDTH, false > tag;
     bool valid;
 
     static const int width = ICACHE_TAG_WIDTH + 2;
@@ -1291,7 +1291,7 @@ struct icache_out_t {
     //
     // Member declarations.
     //
-    sc_uint < ICACHE_LINE > data;
+    ac_int < ICACHE_LINE, false > data;
     bool hit;
 
     static const int width = ICACHE_LINE + 1;
@@ -1369,7 +1369,7 @@ struct dcache_data_t {
     //
     // Member declarations.
     //
-    sc_uint < DCACHE_LINE > data;
+    ac_int < DCACHE_LINE, false > data;
 
     static const int width = DCACHE_LINE;
     //
@@ -1437,7 +1437,7 @@ struct dcache_tag_t {
     //
     // Member declarations.
     //
-    sc_uint < DCACHE_TAG_WIDTH > tag;
+    ac_int < DCACHE_TAG_WIDTH, false > tag;
     bool valid;
     bool dirty;
 
@@ -1523,7 +1523,7 @@ struct dcache_out_t {
     //
     // Member declarations.
     //
-    sc_uint < DCACHE_LINE > data;
+    ac_int < DCACHE_LINE, false > data;
     bool hit;
 
     static const int width = DCACHE_LINE + 1;
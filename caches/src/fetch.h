@@ -25,6 +25,7 @@
 #include "drim4hls_datatypes.h"
 #include "defines.h"
 #include "globals.h"
+#include "../../common/replacement.h"
 
 #include <mc_connections.h>
 
@@ -44,9 +45,9 @@ SC_MODULE(fetch) {
     sc_signal < ac_int < LOG2_NUM_CAUSES, false > > CCS_INIT_S1(trap_cause); //sc_out
 
     // *** Internal variables
-    sc_int < PC_LEN > pc; // Init. to -4, then before first insn fetch it will be updated to 0.	 
-    sc_uint < PC_LEN > imem_pc; // Used in fetching from instruction memory
-	sc_uint < PC_LEN > pc_tmp; // Init. to -4, then before first insn fetch it will be updated to 0.	 
+    ac_int < PC_LEN, true > pc; // Init. to -4, then before first insn fetch it will be updated to 0.	 
+    ac_int < PC_LEN, false > imem_pc; // Used in fetching from instruction memory
+	ac_int < PC_LEN, false > pc_tmp; // Init. to -4, then before first insn fetch it will be updated to 0.	 
     // Custom datatypes used for retrieving and sending data through the channels
     imem_in_t imem_in; // Contains data for fetching from the instruction memory
     fe_out_t fe_out; // Contains data for the decode stage
@@ -56,31 +57,53 @@ SC_MODULE(fetch) {
     bool redirect;
     bool redirect_tmp;
     
-    sc_uint < PC_LEN > redirect_addr;
-	sc_uint < PC_LEN > redirect_addr_tmp;
+    ac_int < PC_LEN, false > redirect_addr;
+	ac_int < PC_LEN, false > redirect_addr_tmp;
 	
-	sc_uint < DATA_SIZE > mem_dout;
-    sc_uint < ICACHE_LINE > imem_data;
-    sc_uint < XLEN > imem_data_offset;
-    
-    sc_uint < ICACHE_TAG_WIDTH + ICACHE_INDEX_WIDTH + 1 > icache_buffer_addr[ICACHE_BUFFER_SIZE][ICACHE_WAYS];
-    sc_uint < ICACHE_LINE > icache_buffer_instr[ICACHE_BUFFER_SIZE][ICACHE_WAYS];
+	ac_int < DATA_SIZE, false > mem_dout;
+    ac_int < ICACHE_LINE, false > imem_data;
+    ac_int < XLEN, false > imem_data_offset;
     
     icache_data_t icache_data[ICACHE_ENTRIES][ICACHE_WAYS];
     icache_tag_t icache_tags[ICACHE_ENTRIES][ICACHE_WAYS];
     icache_out_t icache_out;
     
-    icache_data_t cache_data[1][ICACHE_WAYS];
-    icache_tag_t cache_tag[1][ICACHE_WAYS];
-
-    sc_uint < ICACHE_TAG_WIDTH > tag;
-    sc_uint < ICACHE_INDEX_WIDTH > index;
-    sc_uint < ICACHE_OFFSET_WIDTH + 1 > offset;
+    // Replacement metadata of every set. The data and tag arrays never move.
+    typedef repl_select < ICACHE_WAYS, ICACHE_REPL_POLICY >::type icache_repl_t;
+    static_assert(ICACHE_WAYS_WIDTH == repl_way_width < ICACHE_WAYS >::value, "ICACHE_WAYS_WIDTH does not address every way");
+    icache_repl_t icache_repl[ICACHE_ENTRIES];
+    ac_int < ICACHE_WAYS_WIDTH, false > way; // Way that hit, or victim way on a miss
+    
+    // Refill of the previous iteration. It is written to the arrays one
+    // iteration later, so lookups are bypassed from these registers.
+    bool fill_valid;
+    ac_int < ICACHE_INDEX_WIDTH, false > fill_index;
+    ac_int < ICACHE_WAYS_WIDTH, false > fill_way;
+    ac_int < ICACHE_TAG_WIDTH, false > fill_tag;
+    ac_int < ICACHE_LINE, false > fill_data;
+    
+    // Last line delivered by the I$. Consecutive fetches from the same line
+    // reuse it without reading the tag and data arrays.
+    bool line_valid;
+    ac_int < ICACHE_INDEX_WIDTH, false > line_index;
+    ac_int < ICACHE_TAG_WIDTH, false > line_tag;
+    ac_int < ICACHE_LINE, false > line_data;
     
-    sc_uint < ICACHE_TAG_WIDTH + ICACHE_INDEX_WIDTH > buffer_addr;
+    // Way predictor. Holds for every set the way that hit last, only this
+    // way is read and its tag is verified after the access.
+    ac_int < ICACHE_WAYS_WIDTH, false > way_pred[ICACHE_ENTRIES];
+    bool way_replay; // Wrong way predicted but the line is present, fetch the pc again
+    #if defined(ICACHE_WAY_PREDICTION) && !defined(__SYNTHESIS__)
+    bool way_pred_first; // First access of the fetch, the replay of a wrong way is not counted
+    long int way_pred_correct;
+    long int way_pred_wrong;
+    #endif
+
+    ac_int < ICACHE_TAG_WIDTH, false > tag;
+    ac_int < ICACHE_INDEX_WIDTH, false > index;
+    ac_int < ICACHE_OFFSET_WIDTH + 1, false > offset;
 
     bool freeze;
-	bool hit_buffer;
 		
     SC_CTOR(fetch): imem_din("imem_din"),
     fetch_din("fetch_din"),
@@ -112,20 +135,34 @@ SC_MODULE(fetch) {
             redirect_addr = 0;
 			freeze = false;
 			redirect = false;
-			hit_buffer = false;
             //  Init. pc to START_ADDRESS - 4 as on first fetch it will be incremented by
             //  4, thus fetching instruction at address 0
             pc = -4;
             pc_tmp = -4;
-            buffer_addr = 0;
+            
+            way = 0;
+            fill_valid = false;
+            fill_index = 0;
+            fill_way = 0;
+            fill_tag = 0;
+            fill_data = 0;
+            
+            line_valid = false;
+            line_index = 0;
+            line_tag = 0;
+            line_data = 0;
+            
+            way_replay = false;
+            #if defined(ICACHE_WAY_PREDICTION) && !defined(__SYNTHESIS__)
+            way_pred_first = true;
+            way_pred_correct = 0;
+            way_pred_wrong = 0;
+            #endif
             
             int n = 0;
-            int l = 0;
-            for (n = 0; n < ICACHE_BUFFER_SIZE; n++) {
-                for (l = 0; l < ICACHE_WAYS; l++) {             
-				    icache_buffer_addr[n][l] = 0;
-				    icache_buffer_instr[n][l] = 0;
-				}
+            for (n = 0; n < ICACHE_ENTRIES; n++) {
+				icache_repl[n].reset();
+				way_pred[n] = 0;
 			}
             
             wait();
@@ -145,64 +182,54 @@ SC_MODULE(fetch) {
             // Mechanism for incrementing PC
             if ((redirect && redirect_addr != pc) || freeze) {
                 pc = redirect_addr;
+            } else if (way_replay) {
+                // Wrong I$ way predicted, fetch the same pc again
             } else if (!freeze) {
                 pc = (pc + 4);
             }
 			
             //imem_in.instr_addr = pc;
-			hit_buffer = false;
             fe_out.pc = pc;
             
             unsigned int aligned_addr = pc >> 2;
             imem_in.instr_addr = aligned_addr;
             
-            sc_uint < XLEN > addr = aligned_addr;
+            ac_int < XLEN, false > addr = aligned_addr;
             
-            tag = addr.range(ICACHE_TAG_WIDTH + ICACHE_INDEX_WIDTH + ICACHE_OFFSET_WIDTH - 1, ICACHE_INDEX_WIDTH + ICACHE_OFFSET_WIDTH);
-            index = addr.range(ICACHE_INDEX_WIDTH + ICACHE_OFFSET_WIDTH - 1,ICACHE_OFFSET_WIDTH);        
+            tag = addr.slc<ICACHE_TAG_WIDTH>(ICACHE_INDEX_WIDTH + ICACHE_OFFSET_WIDTH);
+            index = addr.slc<ICACHE_INDEX_WIDTH>(ICACHE_OFFSET_WIDTH);        
 			if (ICACHE_OFFSET_WIDTH) {
-                offset = addr.range(ICACHE_OFFSET_WIDTH - 1, 0);
+                offset = addr.slc<ICACHE_OFFSET_WIDTH>(0);
             }
             else {
 				offset = 0;
 			}
 			
-			buffer_addr.range(ICACHE_INDEX_WIDTH - 1, 0) = index;
-			buffer_addr.range (ICACHE_TAG_WIDTH + ICACHE_INDEX_WIDTH - 1, ICACHE_INDEX_WIDTH) = tag;
+			#if defined(ICACHE_WAY_PREDICTION) && !defined(__SYNTHESIS__)
+			way_pred_first = !way_replay;
+			#endif
+			way_replay = false;
+			#ifdef ICACHE_LINE_REUSE
+			bool line_hit = line_valid && line_index == index && line_tag == tag;
+			#else
+			bool line_hit = false;
+			#endif
 			
-			int m = 0;
-			int n = 0;
-			int k = ICACHE_BUFFER_SIZE - 1;
-			
-			for (k; k > 0; k = k - 1) {
-				for (m = 0; m < ICACHE_WAYS; m++) {
-					icache_buffer_addr[k][m] = icache_buffer_addr[k-1][m];
-					icache_buffer_instr[k][m] = icache_buffer_instr[k-1][m]; 
-				}                 
-			}
-			
-			icache_out = icache();
-			
-			for (m = 0; m < ICACHE_WAYS; m++) {                 
-				icache_buffer_instr[0][m] = cache_data[0][m].data;
-				icache_buffer_addr[0][m].range(0, 0) = (ac_int <1, false>) cache_tag[0][m].valid;
-				icache_buffer_addr[0][m].range(ICACHE_INDEX_WIDTH, 1) = index;
-				icache_buffer_addr[0][m].range(ICACHE_TAG_WIDTH + ICACHE_INDEX_WIDTH, ICACHE_INDEX_WIDTH + 1) = cache_tag[0][m].tag;  
+			if (line_hit) {
+				icache_out.hit = true;
+				icache_out.data = line_data;
+			} else {
+				#ifdef ICACHE_WAY_PREDICTION
+				icache_out = icache_predicted();
+				#else
+				icache_out = icache();
+				#endif
 			}
 			
-			if (!icache_out.hit) {
-				for (n = 0; n < ICACHE_BUFFER_SIZE; n++) {
-					for (m = 0; m < ICACHE_WAYS; m++) {                 
-						if (icache_buffer_addr[n][m].range(ICACHE_TAG_WIDTH + ICACHE_INDEX_WIDTH, 1) == buffer_addr && icache_buffer_addr[n][m].range(0, 0) == 1) {
-							icache_out.data = icache_buffer_instr[n][m];
-							icache_out.hit = true;
-							hit_buffer = true;
-						}
-					}
-				}
-			}
+			// Write the refill of the previous iteration
+			icache_write();
 			
-			sc_uint<ICACHE_LINE> imem_data_tmp = 0;
+			ac_int < ICACHE_LINE, false > imem_data_tmp = 0;
 			int j = 0;
             switch (icache_out.hit)
             {
@@ -233,18 +260,25 @@ SC_MODULE(fetch) {
                     
 					fe_out.instr_data = imem_data_offset;
 					
-					icache_buffer_addr[0][ICACHE_WAYS - 1].range(0, 0) = 1;
-					icache_buffer_addr[0][ICACHE_WAYS - 1].range(ICACHE_TAG_WIDTH + ICACHE_INDEX_WIDTH, 1) = buffer_addr;
-					icache_buffer_instr[0][ICACHE_WAYS - 1] = imem_data;
+					fill_valid = true;
+					fill_index = index;
+					fill_way = way;
+					fill_tag = tag;
+					fill_data = imem_data;
                     
                     break;
                 default:
                     break;
             }
             
-			icache_write();
+            line_valid = !way_replay;
+            line_index = index;
+            line_tag = tag;
+            line_data = imem_data;
 			
-            dout.Push(fe_out);
+            if (!way_replay) {
+				dout.Push(fe_out);
+			}
 			
 			#ifndef __SYNTHESIS__
             DPRINT("@" << sc_time_stamp() << "\t" << name() << "\t" << std::hex << "pc= " << pc << endl);
@@ -255,68 +289,139 @@ SC_MODULE(fetch) {
         } // *** ENDOF while(true)
     } // *** ENDOF sc_cthread
     
+    #if defined(ICACHE_WAY_PREDICTION) && !defined(__SYNTHESIS__)
+    void end_of_simulation() {
+        long int way_pred_total = way_pred_correct + way_pred_wrong;
+        std::cout << "I$ WAY PREDICTION: " << std::dec << way_pred_correct << "/" << way_pred_total << " correct";
+        if (way_pred_total > 0) {
+            std::cout << " (" << (100.0 * way_pred_correct) / way_pred_total << "%)";
+        }
+        std::cout << std::endl;
+    }
+    #endif
+    
     icache_out_t icache () {
 
         icache_out_t iout;
-        icache_tag_t tmp_tag;
-        icache_data_t tmp_data;
         iout.data = 0;
         iout.hit = false;
 
+        // The refill of the previous iteration is not yet in the arrays
+        bool fill_set = fill_valid && fill_index == index;
+
+        bool invalid_found = false;
+        ac_int < ICACHE_WAYS_WIDTH, false > invalid_way = 0;
+
 		int i = 0;
-        int j = 0;
 
         for (i = 0; i < ICACHE_WAYS; i++) {
-            cache_tag[0][i] = icache_tags[index][i];
-            cache_data[0][i] = icache_data[index][i];
+            icache_tag_t way_tag = icache_tags[index][i];
+            
+            if (fill_set && fill_way == i) {
+				way_tag.tag = fill_tag;
+				way_tag.valid = true;
+			}
 
-            if ((tag == cache_tag[0][i].tag) && (cache_tag[0][i].valid)) {
-                              
-                tmp_data = cache_data[0][i];
-                tmp_tag = cache_tag[0][i];
+            if ((tag == way_tag.tag) && (way_tag.valid)) {
+                iout.data = (fill_set && fill_way == i) ? fill_data : icache_data[index][i].data;
                 iout.hit = true;
-                j = i;
+                way = i;
+            } else if (!way_tag.valid && !invalid_found) {
+				invalid_way = i;
+				invalid_found = true;
+			}
 
-            }
+		}
 
+        if (iout.hit) {
+            icache_repl[index].touch(way);
+		} else {
+			way = invalid_found ? invalid_way : (ac_int < ICACHE_WAYS_WIDTH, false >) icache_repl[index].victim();
+			icache_repl[index].insert(way);
 		}
-		
-		for (i = ICACHE_WAYS - 1; i > 0; i--) {
-			if (iout.hit && i <= j) {
-				cache_data[0][i] = cache_data[0][i-1];
-				cache_tag[0][i] = cache_tag[0][i-1];
-			}
-				
+
+        return iout;
+    }
+    
+    icache_out_t icache_predicted () {
+
+        icache_out_t iout;
+        iout.data = 0;
+        iout.hit = false;
+
+        bool fill_set = fill_valid && fill_index == index;
+        ac_int < ICACHE_WAYS_WIDTH, false > pred = way_pred[index];
+
+        // Access only the predicted way and verify its tag
+        icache_tag_t pred_tag = icache_tags[index][pred];
+        if (fill_set && fill_way == pred) {
+			pred_tag.tag = fill_tag;
+			pred_tag.valid = true;
 		}
 
-        if (iout.hit) {
-			
-            cache_data[0][0] = tmp_data;
-            cache_tag[0][0] = tmp_tag;
-		}else {
-			tmp_data = cache_data[0][ICACHE_WAYS - 1];
+        if ((tag == pred_tag.tag) && (pred_tag.valid)) {
+            iout.data = (fill_set && fill_way == pred) ? fill_data : icache_data[index][pred].data;
+            iout.hit = true;
+            way = pred;
+            icache_repl[index].touch(way);
+            #if defined(ICACHE_WAY_PREDICTION) && !defined(__SYNTHESIS__)
+            if (way_pred_first) {
+                way_pred_correct++;
+            }
+            #endif
+            return iout;
+        }
+
+        // Wrong way: compare the remaining tags, no data is read
+        bool tag_hit = false;
+        bool invalid_found = false;
+        ac_int < ICACHE_WAYS_WIDTH, false > invalid_way = 0;
+
+		int i = 0;
+
+        for (i = 0; i < ICACHE_WAYS; i++) {
+            icache_tag_t way_tag = icache_tags[index][i];
+
+            if (fill_set && fill_way == i) {
+				way_tag.tag = fill_tag;
+				way_tag.valid = true;
+			}
+
+            if ((tag == way_tag.tag) && (way_tag.valid)) {
+                tag_hit = true;
+                way = i;
+            } else if (!way_tag.valid && !invalid_found) {
+				invalid_way = i;
+				invalid_found = true;
+			}
 		}
 
-        iout.data = tmp_data.data;
+        if (tag_hit) {
+            // The line is read from the right way on the next cycle
+            way_replay = true;
+            iout.hit = true;
+            #if defined(ICACHE_WAY_PREDICTION) && !defined(__SYNTHESIS__)
+            if (way_pred_first) {
+                way_pred_wrong++;
+            }
+            #endif
+		} else {
+			way = invalid_found ? invalid_way : (ac_int < ICACHE_WAYS_WIDTH, false >) icache_repl[index].victim();
+			icache_repl[index].insert(way);
+		}
+        way_pred[index] = way;
 
         return iout;
     }
     
     void icache_write () {
-			
-        sc_uint < ICACHE_INDEX_WIDTH > write_index = icache_buffer_addr[1][0].range(ICACHE_INDEX_WIDTH, 1);
-        int i = 0;
-        for (i = 0; i < ICACHE_WAYS; i++) {                 
 
-            if (hit_buffer) {
-				icache_buffer_instr[0][i] = icache_buffer_instr[1][i];
-				icache_buffer_addr[0][i] = icache_buffer_addr[1][i];
-			}
-				icache_data[write_index][i].data = icache_buffer_instr[1][i];
-				icache_tags[write_index][i].valid = icache_buffer_addr[1][i].range(0,0);
-				icache_tags[write_index][i].tag = icache_buffer_addr[1][i].range(ICACHE_INDEX_WIDTH + ICACHE_TAG_WIDTH, 1 + ICACHE_INDEX_WIDTH);
-        }
-                      
+        if (fill_valid) {
+			icache_data[fill_index][fill_way].data = fill_data;
+			icache_tags[fill_index][fill_way].tag = fill_tag;
+			icache_tags[fill_index][fill_way].valid = true;
+		}
+		fill_valid = false;
 
     }
 };
@@ -39,12 +39,12 @@ class Top: public sc_module {
     Connections::Combinational < dmem_out_t > CCS_INIT_S1(dmem2wb_ch);
     Connections::Combinational < dmem_in_t > CCS_INIT_S1(wb2dmem_ch);
 
-    sc_uint < XLEN > imem[ICACHE_SIZE];
+    ac_int < XLEN, false > imem[ICACHE_SIZE];
 
     imem_out_t imem_dout;
     imem_in_t imem_din;
 
-    sc_uint < XLEN > dmem[DCACHE_SIZE];
+    ac_int < XLEN, false > dmem[DCACHE_SIZE];
 
     dmem_out_t dmem_dout;
     dmem_in_t dmem_din;
@@ -98,18 +98,18 @@ class Top: public sc_module {
         IMEM_BODY: while (true) {
             imem_din = fe2imem_ch.Pop();
 
-            sc_uint < XLEN > addr = imem_din.instr_addr.to_uint();
+            ac_int < XLEN, false > addr = imem_din.instr_addr.to_uint();
 			std::cout << "fetch instr " << endl;
 			
 			unsigned int offset_lenght = pow(2 , ICACHE_OFFSET_WIDTH);
 			            
             for (int i = 0; i < offset_lenght; i++) {
 				if (ICACHE_OFFSET_WIDTH) {
-					addr.range(ICACHE_OFFSET_WIDTH - 1, 0) = (sc_uint < ICACHE_OFFSET_WIDTH >) i;                        
+					addr.set_slc(0, (ac_int < ICACHE_OFFSET_WIDTH, false >) i);                        
                 }
 				std::cout << "imem addr= " << addr << endl;
 
-                imem_dout.instr_data.range(i*XLEN + XLEN -1, i*XLEN) = imem[addr];
+                imem_dout.instr_data.set_slc(i*XLEN, imem[addr]);
                 std::cout << "imem[" << addr << "]=" << imem[addr] << endl;
 			}
 
@@ -133,12 +133,12 @@ class Top: public sc_module {
         DMEM_BODY: while (true) {
             dmem_din = wb2dmem_ch.Pop();
 
-			sc_uint < XLEN > addr = dmem_din.data_addr.to_uint();
-			sc_uint < XLEN > write_addr = dmem_din.write_addr.to_uint();
+			ac_int < XLEN, false > addr = dmem_din.data_addr.to_uint();
+			ac_int < XLEN, false > write_addr = dmem_din.write_addr.to_uint();
 			
 			unsigned int addr_lenght = DCACHE_TAG_WIDTH + DCACHE_INDEX_WIDTH;
             unsigned int offset_lenght = pow(2 , DCACHE_OFFSET_WIDTH);
-            sc_uint < DCACHE_INDEX_WIDTH > index = addr.range(DCACHE_INDEX_WIDTH + DCACHE_OFFSET_WIDTH - 1, DCACHE_OFFSET_WIDTH);
+            ac_int < DCACHE_INDEX_WIDTH, false > index = addr.slc<DCACHE_INDEX_WIDTH>(DCACHE_OFFSET_WIDTH);
             
             unsigned int random_stalls = 15;
             wait_stalls += random_stalls;
@@ -149,11 +149,11 @@ class Top: public sc_module {
 
                 for (int i = 0; i < offset_lenght; i++) {
                     if (DCACHE_OFFSET_WIDTH) {
-                        addr.range(DCACHE_OFFSET_WIDTH - 1, 0) = (sc_uint < DCACHE_OFFSET_WIDTH >) i;                        
+                        addr.set_slc(0, (ac_int < DCACHE_OFFSET_WIDTH, false >) i);                        
                     }
                     std::cout << "dmem addr= " << addr << endl;
 
-                    dmem_dout.data_out.range(i*XLEN + XLEN -1, i*XLEN) = dmem[addr];
+                    dmem_dout.data_out.set_slc(i*XLEN, dmem[addr]);
                     std::cout << "dmem[" << addr << "]=" << dmem[addr] << endl;
                 }
                 
@@ -164,10 +164,10 @@ class Top: public sc_module {
                 
                 for (int i = 0; i < offset_lenght; i++) {
                     if (DCACHE_OFFSET_WIDTH) {
-                        write_addr.range(DCACHE_OFFSET_WIDTH - 1, 0) = (sc_uint < DCACHE_OFFSET_WIDTH >) i;
+                        write_addr.set_slc(0, (ac_int < DCACHE_OFFSET_WIDTH, false >) i);
                     }
                     std::cout << "dmem addr= " << write_addr << endl;
-                    dmem[write_addr] = dmem_din.data_in.range(i*XLEN + XLEN - 1, i*XLEN);
+                    dmem[write_addr] = dmem_din.data_in.slc<XLEN>(i*XLEN);
                     std::cout << "dmem[" << write_addr << "]=" << dmem[write_addr] << endl;
                 }
             }
@@ -27,6 +27,7 @@
 #include "drim4hls_datatypes.h"
 #include "defines.h"
 #include "globals.h"
+#include "../../common/replacement.h"
 
 #include <mc_connections.h>
 
@@ -38,8 +39,8 @@ SC_MODULE(writeback) {
         // Member declarations.
         //		
         unsigned int aligned_address;
-        sc_uint < XLEN > load_data;
-        sc_uint < XLEN > store_data;
+        ac_int < XLEN, false > load_data;
+        ac_int < XLEN, false > store_data;
         std::string load;
         std::string store;
 
@@ -64,20 +65,25 @@ SC_MODULE(writeback) {
     dmem_out_t dmem_din;
     mem_out_t output;
 
-    sc_uint < DATA_SIZE > mem_dout;
-    sc_uint < DCACHE_LINE > dmem_data;
-    sc_uint < XLEN > dmem_data_offset;
+    ac_int < DATA_SIZE, false > mem_dout;
+    ac_int < DCACHE_LINE, false > dmem_data;
+    ac_int < XLEN, false > dmem_data_offset;
     
     dcache_data_t dcache_data[DCACHE_ENTRIES][DCACHE_WAYS];
     dcache_tag_t dcache_tags[DCACHE_ENTRIES][DCACHE_WAYS];
     dcache_out_t dcache_out;
     
-    dcache_data_t cache_data[1][DCACHE_WAYS];
-    dcache_tag_t cache_tag[1][DCACHE_WAYS];
-
-    sc_uint < DCACHE_TAG_WIDTH > tag;
-    sc_uint < DCACHE_INDEX_WIDTH > index;
-    sc_uint < DCACHE_OFFSET_WIDTH + 1 > offset;
+    // Replacement metadata of every set. The data and tag arrays never move.
+    typedef repl_select < DCACHE_WAYS, DCACHE_REPL_POLICY >::type dcache_repl_t;
+    static_assert(DCACHE_WAYS_WIDTH == repl_way_width < DCACHE_WAYS >::value, "DCACHE_WAYS_WIDTH does not address every way");
+    dcache_repl_t dcache_repl[DCACHE_ENTRIES];
+    ac_int < DCACHE_WAYS_WIDTH, false > way; // Way that hit, or victim way on a miss
+    dcache_data_t way_data; // Line held by way
+    dcache_tag_t way_tag; // Tag of way
+
+    ac_int < DCACHE_TAG_WIDTH, false > tag;
+    ac_int < DCACHE_INDEX_WIDTH, false > index;
+    ac_int < DCACHE_OFFSET_WIDTH + 1, false > offset;
         
     bool freeze;
     // Constructor
@@ -112,6 +118,11 @@ SC_MODULE(writeback) {
             index = 0;
             offset = 0;
 			freeze = false;
+			
+			way = 0;
+			for (int n = 0; n < DCACHE_ENTRIES; n++) {
+				dcache_repl[n].reset();
+			}
         }
 
         #pragma hls_pipeline_init_interval 1
@@ -138,25 +149,25 @@ SC_MODULE(writeback) {
             // Preprocess address
 			
             unsigned int aligned_address = input.alu_res.to_uint();
-            sc_uint< 5 > byte_index = (sc_uint< 5 >)((aligned_address & 0x3) << 3);
-            sc_uint< 5 > halfword_index = (sc_uint< 5 >)((aligned_address & 0x2) << 3);
+            ac_int < 5, false > byte_index = (ac_int < 5, false >)((aligned_address & 0x3) << 3);
+            ac_int < 5, false > halfword_index = (ac_int < 5, false >)((aligned_address & 0x2) << 3);
 
             aligned_address = aligned_address >> 2;
-            sc_uint < BYTE > db = (sc_uint < BYTE >) 0;
-            sc_uint < 2 * BYTE > dh = (sc_uint < 2 * BYTE >) 0;
-            sc_uint < XLEN > dw = (sc_uint < XLEN >) 0;
+            ac_int < BYTE, false > db = (ac_int < BYTE, false >) 0;
+            ac_int < 2 * BYTE, false > dh = (ac_int < 2 * BYTE, false >) 0;
+            ac_int < XLEN, false > dw = (ac_int < XLEN, false >) 0;
 
             dmem_dout.data_addr = aligned_address;
 
             dmem_dout.read_en = false;
             dmem_dout.write_en = false;
             
-            sc_uint < XLEN > addr = aligned_address;
+            ac_int < XLEN, false > addr = aligned_address;
             
-            tag = addr.range(DCACHE_INDEX_WIDTH + DCACHE_OFFSET_WIDTH + DCACHE_TAG_WIDTH - 1, DCACHE_INDEX_WIDTH + DCACHE_OFFSET_WIDTH);
-            index = addr.range(DCACHE_INDEX_WIDTH + DCACHE_OFFSET_WIDTH - 1, DCACHE_OFFSET_WIDTH);
+            tag = addr.slc<DCACHE_TAG_WIDTH>(DCACHE_INDEX_WIDTH + DCACHE_OFFSET_WIDTH);
+            index = addr.slc<DCACHE_INDEX_WIDTH>(DCACHE_OFFSET_WIDTH);
             if (DCACHE_OFFSET_WIDTH) {
-                offset = addr.range(DCACHE_OFFSET_WIDTH - 1, 0);
+                offset = addr.slc<DCACHE_OFFSET_WIDTH>(0);
             }
             else {
 				offset = 0;
@@ -164,7 +175,7 @@ SC_MODULE(writeback) {
            //unsigned int max_offset = 1 << DCACHE_OFFSET_WIDTH;
 
             #ifndef __SYNTHESIS__
-            if (sc_uint < 3 > (input.ld) != NO_LOAD || sc_uint < 2 > (input.st) != NO_STORE) {
+            if (ac_int < 3, false > (input.ld) != NO_LOAD || ac_int < 2, false > (input.st) != NO_STORE) {
                 if (input.mem_datain.to_uint() == 0x11111111 ||
                     input.mem_datain.to_uint() == 0x22222222 ||
                     input.mem_datain.to_uint() == 0x11223344 ||
@@ -177,7 +188,7 @@ SC_MODULE(writeback) {
                 //sc_assert(aligned_address < DCACHE_SIZE);
             }
             #endif
-            sc_uint<DCACHE_LINE> dmem_data_tmp = 0;
+            ac_int < DCACHE_LINE, false > dmem_data_tmp = 0;
 			if ((input.ld != NO_LOAD || input.st != NO_STORE) && !freeze) { // a load is requested
 				freeze = true;
                 dcache_out = dcache();
@@ -194,14 +205,14 @@ SC_MODULE(writeback) {
 						dmem_data_offset[i] = dmem_data[index_word];
 					}
                     
-                    if (cache_tag[0][0].dirty && input.st != NO_STORE && cache_tag[0][0].tag != tag) {
+                    if (way_tag.dirty && input.st != NO_STORE && way_tag.tag != tag) {
                         dmem_dout.write_en = true;
                         dmem_dout.data_in = dcache_out.data;
                         if (DCACHE_OFFSET_WIDTH) {
 							dmem_dout.write_addr = 0;
 						}
-						dmem_dout.write_addr.range(DCACHE_INDEX_WIDTH + DCACHE_OFFSET_WIDTH - 1, DCACHE_OFFSET_WIDTH) = index;
-						dmem_dout.write_addr.range(DCACHE_TAG_WIDTH + DCACHE_INDEX_WIDTH + DCACHE_OFFSET_WIDTH - 1 , DCACHE_INDEX_WIDTH + DCACHE_OFFSET_WIDTH) = cache_tag[0][0].tag;
+						dmem_dout.write_addr.set_slc(DCACHE_OFFSET_WIDTH, index);
+						dmem_dout.write_addr.set_slc(DCACHE_INDEX_WIDTH + DCACHE_OFFSET_WIDTH, way_tag.tag);
                         
                         dmem_in.Push(dmem_dout);
                     }
@@ -211,15 +222,15 @@ SC_MODULE(writeback) {
 				
                     dmem_dout.read_en = true;
                     
-                    if (cache_tag[0][DCACHE_WAYS - 1].dirty && cache_tag[0][DCACHE_WAYS - 1].tag != tag) {
+                    if (way_tag.dirty && way_tag.tag != tag) {
                         dmem_dout.write_en = true;
                         dmem_dout.data_in = dcache_out.data;
                         
                         if (DCACHE_OFFSET_WIDTH) {
 							dmem_dout.write_addr = 0;
 						}
-						dmem_dout.write_addr.range(DCACHE_INDEX_WIDTH + DCACHE_OFFSET_WIDTH - 1, DCACHE_OFFSET_WIDTH) = index;
-						dmem_dout.write_addr.range(DCACHE_TAG_WIDTH + DCACHE_INDEX_WIDTH + DCACHE_OFFSET_WIDTH - 1, DCACHE_INDEX_WIDTH + DCACHE_OFFSET_WIDTH) = cache_tag[0][DCACHE_WAYS - 1].tag;
+						dmem_dout.write_addr.set_slc(DCACHE_OFFSET_WIDTH, index);
+						dmem_dout.write_addr.set_slc(DCACHE_INDEX_WIDTH + DCACHE_OFFSET_WIDTH, way_tag.tag);
                     }
                     
                     dmem_in.Push(dmem_dout);
@@ -233,10 +244,10 @@ SC_MODULE(writeback) {
 						dmem_data_offset[i] = dmem_data[index_word];
 					}
 
-                    dmem_dout.data_in = cache_data[0][DCACHE_WAYS - 1].data;
+                    dmem_dout.data_in = way_data.data;
                     
                     if (input.ld != NO_LOAD) {
-						cache_data[0][DCACHE_WAYS - 1].data = dmem_data;
+						way_data.data = dmem_data;
 					}
                     
                     break;
@@ -249,7 +260,7 @@ SC_MODULE(writeback) {
                 
                 switch (input.ld) { // LOAD
                 case LB_LOAD:                    
-                    db.range(BYTE - 1, 0) = dmem_data_offset.range(BYTE + byte_index - 1, byte_index);
+                    db.set_slc(0, dmem_data_offset.slc<BYTE>(byte_index));
                     mem_dout = ext_sign_byte(db);
 
                     #ifndef __SYNTHESIS__
@@ -259,7 +270,7 @@ SC_MODULE(writeback) {
 
                     break;
                 case LH_LOAD:
-                    dh.range(2*BYTE - 1, 0) = dmem_data_offset.range(2*BYTE + halfword_index - 1, halfword_index);
+                    dh.set_slc(0, dmem_data_offset.slc<2*BYTE>(halfword_index));
                     mem_dout = ext_sign_halfword(dh);
 
                     #ifndef __SYNTHESIS__
@@ -279,7 +290,7 @@ SC_MODULE(writeback) {
 
                     break;
                 case LBU_LOAD:
-                    db.range(BYTE - 1, 0) = dmem_data_offset.range(BYTE + byte_index - 1, byte_index);
+                    db.set_slc(0, dmem_data_offset.slc<BYTE>(byte_index));
                     mem_dout = ext_unsign_byte(db);
 
                     #ifndef __SYNTHESIS__
@@ -289,7 +300,7 @@ SC_MODULE(writeback) {
 
                     break;
                 case LHU_LOAD:
-                    dh.range(2 * BYTE - 1, 0) = dmem_data_offset.range(2 * BYTE + halfword_index - 1, halfword_index);
+                    dh.set_slc(0, dmem_data_offset.slc<2*BYTE>(halfword_index));
                     mem_dout = ext_unsign_halfword(dh);
 
                     #ifndef __SYNTHESIS__
@@ -312,8 +323,8 @@ SC_MODULE(writeback) {
                 switch (input.st) { // STORE
                 case SB_STORE: // store 8 bits of rs2
 					
-					db.range(BYTE - 1, 0) = (sc_uint < BYTE >) input.mem_datain.range(BYTE - 1, 0);
-					dmem_data_offset.range(BYTE + byte_index - 1, byte_index) = (sc_uint < BYTE >) db;
+					db.set_slc(0, (ac_int < BYTE, false >) input.mem_datain.slc<BYTE>(0));
+					dmem_data_offset.set_slc(byte_index, (ac_int < BYTE, false >) db);
 
                     #ifndef __SYNTHESIS__
                     writeback_out_t.store_data = db;
@@ -323,8 +334,8 @@ SC_MODULE(writeback) {
                     break;
                 case SH_STORE: // store 16 bits of rs2
 
-					dh.range(2*BYTE - 1, 0) = input.mem_datain.range(2*BYTE - 1, 0);
-					dmem_data_offset.range(2 * BYTE + byte_index - 1, byte_index) = dh;
+					dh.set_slc(0, input.mem_datain.slc<2*BYTE>(0));
+					dmem_data_offset.set_slc(byte_index, dh);
                     
                     #ifndef __SYNTHESIS__
                     writeback_out_t.store_data = dh;
@@ -357,13 +368,8 @@ SC_MODULE(writeback) {
 					dmem_data[index_word] = dmem_data_offset[i];
 				}
 				
-                if (dcache_out.hit) {
-                    dmem_dout.data_in = cache_data[0][0].data;
-                    cache_data[0][0].data = dmem_data;
-                }else {
-                    dmem_dout.data_in = cache_data[0][DCACHE_WAYS - 1].data;
-                    cache_data[0][DCACHE_WAYS - 1].data = dmem_data;
-                }
+                dmem_dout.data_in = way_data.data;
+                way_data.data = dmem_data;
                 
             }
             
@@ -406,128 +412,111 @@ SC_MODULE(writeback) {
     /* Support functions */
 
     // Sign extend byte read from memory. For LB
-    sc_uint < XLEN > ext_sign_byte(sc_uint < BYTE > read_data) {
-		sc_uint <XLEN > extended = 0;
+    ac_int < XLEN, false > ext_sign_byte(ac_int < BYTE, false > read_data) {
+		ac_int < XLEN, false > extended = 0;
 		if (read_data[7] == 1) {
-			extended.range(BYTE - 1, 0) = read_data;
-			extended.range(BYTE * 4 - 1, BYTE) = (sc_uint < BYTE * 3 >) 16777216;
+			extended.set_slc(0, read_data);
+			extended.set_slc(BYTE, (ac_int < BYTE * 3, false >) 16777215);
 		}
 		else {
-			extended.range(BYTE - 1, 0) = read_data;
-			extended.range(BYTE * 4 - 1, BYTE) = (sc_uint < BYTE * 3 >) 0;	
+			extended.set_slc(0, read_data);
+			extended.set_slc(BYTE, (ac_int < BYTE * 3, false >) 0);	
 		}
 		return extended;
     }
 
     // Zero extend byte read from memory. For LBU
-    sc_uint < XLEN > ext_unsign_byte(sc_uint < BYTE > read_data) {
-		sc_uint <XLEN> extended = 0;
-		extended.range(BYTE - 1, 0) = read_data;
-		extended.range(BYTE * 4 - 1, BYTE) = (sc_uint < BYTE * 3 >) 0;	
+    ac_int < XLEN, false > ext_unsign_byte(ac_int < BYTE, false > read_data) {
+		ac_int < XLEN, false > extended = 0;
+		extended.set_slc(0, read_data);
+		extended.set_slc(BYTE, (ac_int < BYTE * 3, false >) 0);	
 		return extended;        
     }
 
     // Sign extend half-word read from memory. For LH
-    sc_uint < XLEN > ext_sign_halfword(sc_uint < BYTE * 2 > read_data) {
-		sc_uint <XLEN> extended = 0;
+    ac_int < XLEN, false > ext_sign_halfword(ac_int < BYTE * 2, false > read_data) {
+		ac_int < XLEN, false > extended = 0;
 		        
         if (read_data[15] == 1) {
-			extended.range(BYTE * 2 - 1, 0) = read_data;
-			extended.range(BYTE * 4 - 1, 2*BYTE) = (sc_uint < BYTE * 2 >) 65535;
+			extended.set_slc(0, read_data);
+			extended.set_slc(2*BYTE, (ac_int < BYTE * 2, false >) 65535);
         }
         else {
-			extended.range(BYTE * 2 - 1, 0) = read_data;
-			extended.range(BYTE * 4 - 1, 2*BYTE) = (sc_uint < BYTE * 2 >) 0;
+			extended.set_slc(0, read_data);
+			extended.set_slc(2*BYTE, (ac_int < BYTE * 2, false >) 0);
         }
         return extended;
     }
 
     // Zero extend half-word read from memory. For LHU
-    sc_uint < XLEN > ext_unsign_halfword(sc_uint < BYTE * 2 > read_data) {
-		sc_uint <XLEN> extended = 0;
-		extended.range(BYTE * 2 - 1, 0) = read_data;
-		extended.range(BYTE * 4 - 1, 2*BYTE) = (sc_uint < BYTE * 2 >) 0;
+    ac_int < XLEN, false > ext_unsign_halfword(ac_int < BYTE * 2, false > read_data) {
+		ac_int < XLEN, false > extended = 0;
+		extended.set_slc(0, read_data);
+		extended.set_slc(2*BYTE, (ac_int < BYTE * 2, false >) 0);
 		return extended;
     }
     
     dcache_out_t dcache () {
 
         dcache_out_t dout;
-        dcache_tag_t tmp_tag;
-        dcache_data_t tmp_data;
         dout.data = 0;
         dout.hit = false;
 
+        bool invalid_found = false;
+        ac_int < DCACHE_WAYS_WIDTH, false > invalid_way = 0;
+
 		int i = 0;
-        int j = 0;
 
         for (i = 0; i < DCACHE_WAYS; i++) {
-            cache_tag[0][i] = dcache_tags[index][i];
-            cache_data[0][i] = dcache_data[index][i];
+            dcache_tag_t set_tag = dcache_tags[index][i];
 
-            if ((tag == cache_tag[0][i].tag) && (cache_tag[0][i].valid)) {
-                              
-                tmp_data = cache_data[0][i];
-                tmp_tag = cache_tag[0][i];
+            if ((tag == set_tag.tag) && (set_tag.valid)) {
                 dout.hit = true;
-                j = i;
-
-            }
-
-		}
-		
-		for (i = DCACHE_WAYS - 1; i > 0; i--) {
-			if (dout.hit && i <= j) {
-				cache_data[0][i] = cache_data[0][i-1];
-				cache_tag[0][i] = cache_tag[0][i-1];
+                way = i;
+            } else if (!set_tag.valid && !invalid_found) {
+				invalid_way = i;
+				invalid_found = true;
 			}
-				
+
 		}
 
-        if (dout.hit) {
-			
-            cache_data[0][0] = tmp_data;
-            cache_tag[0][0] = tmp_tag;
-		}else {
-			tmp_data = cache_data[0][DCACHE_WAYS - 1];
+        if (!dout.hit) {
+			way = invalid_found ? invalid_way : (ac_int < DCACHE_WAYS_WIDTH, false >) dcache_repl[index].victim();
 		}
 
-        dout.data = tmp_data.data;
+        way_tag = dcache_tags[index][way];
+        way_data = dcache_data[index][way];
+
+        // On a miss this is the line of the victim, used for the write-back
+        dout.data = way_data.data;
 
         return dout;
     }
     
     void dcache_write (bool load, bool hit) {
-				
-		unsigned int bank = 0;
-        if (!hit) {
-            bank = DCACHE_WAYS - 1;
-        }
 
-
-        if (cache_tag[0][bank].dirty && cache_tag[0][bank].tag != tag && !(load && hit)) {
-
-            cache_tag[0][bank].tag = tag;
-            cache_tag[0][bank].valid = true;
-     
-        } else if (!(load && hit)) { 
-            
-            cache_tag[0][bank].tag = tag;
-            cache_tag[0][bank].valid = true;
+        if (!(load && hit)) {
+            way_tag.tag = tag;
+            way_tag.valid = true;
         }
 
         if (!load) {
-            cache_tag[0][bank].dirty = true;
+            way_tag.dirty = true;
         }else if (!hit){
-            cache_tag[0][bank].dirty = false;
+            way_tag.dirty = false;
         }
         
-        int i = 0;
-        for (i = 0; i < DCACHE_WAYS; i++) {                 
-            dcache_data[index][i] = cache_data[0][i];
-            dcache_tags[index][i] = cache_tag[0][i];
+        // Load hits leave the line untouched, only the replacement metadata changes
+        if (!(load && hit)) {
+            dcache_data[index][way] = way_data;
+            dcache_tags[index][way] = way_tag;
+        }
 
-        }      
+        if (hit) {
+            dcache_repl[index].touch(way);
+        } else {
+            dcache_repl[index].insert(way);
+        }
 
     }
 
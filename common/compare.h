@@ -0,0 +1,62 @@
+/*
+	@author VLSI Lab, EE dept., Democritus University of Thrace
+
+	@brief Header file for the comparator unit
+
+	@note
+		- A single subtract rs1 - rs2 on XLEN + 1 bits gives every relation
+		  of the operands: the borrow out is the unsigned less-than, the
+		  signed less-than is the borrow unless the signs differ, and a zero
+		  difference is the equality.
+
+		- The conditional branches are resolved with it, in decode or in
+		  execute depending on the version, and so are FLT/FLE of execute_fp.
+
+		- Shared by all the versions of the processor. It is included after
+		  the defines.h and globals.h of the version, which give XLEN and
+		  the FUNCT3 codes.
+
+*/
+
+#ifndef __COMPARE__H
+#define __COMPARE__H
+
+#include <ac_int.h>
+
+struct compare_t {
+    bool eq; // rs1 == rs2
+    bool lt; // rs1 < rs2, signed
+    bool ltu; // rs1 < rs2, unsigned
+};
+
+inline compare_t compare(ac_int < XLEN, false > rs1, ac_int < XLEN, false > rs2) {
+    ac_int < XLEN + 1, false > diff = (ac_int < XLEN + 1, false >) rs1 - (ac_int < XLEN + 1, false >) rs2;
+    compare_t cmp;
+    cmp.eq = (diff.slc < XLEN > (0) == 0);
+    cmp.ltu = (diff[XLEN] == 1); // Borrow out
+    // Operands of different sign: the negative one is the smaller
+    cmp.lt = (rs1[XLEN - 1] != rs2[XLEN - 1]) ? (rs1[XLEN - 1] == 1) : cmp.ltu;
+    return cmp;
+}
+
+// Condition of the conditional branch with the given funct3
+inline bool branch_taken(compare_t cmp, ac_int < 3, false > funct3) {
+    switch (funct3) {
+    case FUNCT3_BEQ:
+        return cmp.eq;
+    case FUNCT3_BNE:
+        return !cmp.eq;
+    case FUNCT3_BLT:
+        return cmp.lt;
+    case FUNCT3_BGE:
+        return !cmp.lt;
+    case FUNCT3_BLTU:
+        return cmp.ltu;
+    case FUNCT3_BGEU:
+        return !cmp.ltu;
+    default:
+        return false;
+    }
+}
+
+#endif
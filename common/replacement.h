@@ -0,0 +1,272 @@
+/*
+	@author VLSI Lab, EE dept., Democritus University of Thrace
+
+	@brief Header file for the cache replacement policies
+
+	@note
+		- Each policy keeps its own per-set metadata, so the data and tag
+		  arrays of the caches are never reordered on a hit.
+
+		- All policies share the same interface:
+			reset()      initializes the metadata of the set
+			victim()     returns the way that must be replaced on a miss
+			touch(way)   updates the metadata after a hit in way
+			insert(way)  updates the metadata after a refill of way
+
+		- The policy of each cache is selected in defines.h with
+		  ICACHE_REPL_POLICY and DCACHE_REPL_POLICY.
+
+		- Shared by the versions with caches. It is included after the
+		  defines.h of the version, which gives the REPL_* codes.
+
+*/
+
+#ifndef __REPLACEMENT__H
+#define __REPLACEMENT__H
+
+#include <mc_connections.h>
+#include <ac_int.h>
+
+// Number of bits needed to address one of WAYS ways (at least one bit).
+template < int WAYS >
+struct repl_way_width {
+    static const int value = (ac::log2_ceil < WAYS >::val > 0) ? ac::log2_ceil < WAYS >::val : 1;
+};
+
+// ------------ True LRU
+// Every way holds its age inside the set, 0 is the most recently used
+// way and WAYS - 1 the least recently used one.
+template < int WAYS >
+struct lru_repl_t {
+    static const int WIDTH = repl_way_width < WAYS >::value;
+
+    ac_int < WIDTH, false > age[WAYS];
+
+    void reset() {
+        #pragma unroll yes
+        for (int i = 0; i < WAYS; i++) {
+            age[i] = i;
+        }
+    }
+
+    ac_int < WIDTH, false > victim() {
+        ac_int < WIDTH, false > way = 0;
+        #pragma unroll yes
+        for (int i = 0; i < WAYS; i++) {
+            if (age[i] == WAYS - 1) {
+                way = i;
+            }
+        }
+        return way;
+    }
+
+    void touch(ac_int < WIDTH, false > way) {
+        ac_int < WIDTH, false > way_age = age[way];
+        #pragma unroll yes
+        for (int i = 0; i < WAYS; i++) {
+            if (age[i] < way_age) {
+                age[i] = age[i] + 1;
+            }
+        }
+        age[way] = 0;
+    }
+
+    void insert(ac_int < WIDTH, false > way) {
+        touch(way);
+    }
+};
+
+// ------------ Tree pseudo-LRU
+// WAYS - 1 bits organized as a binary tree, every node points to the
+// half of the set that must be replaced next. WAYS must be a power of 2.
+template < int WAYS >
+struct plru_repl_t {
+    static const int WIDTH = repl_way_width < WAYS >::value;
+    static const int LEVELS = ac::log2_ceil < WAYS >::val;
+    static const int NODES = (WAYS > 1) ? WAYS - 1 : 1;
+
+    bool tree[NODES];
+
+    void reset() {
+        #pragma unroll yes
+        for (int i = 0; i < NODES; i++) {
+            tree[i] = false;
+        }
+    }
+
+    ac_int < WIDTH, false > victim() {
+        ac_int < WIDTH, false > way = 0;
+        int node = 0;
+        #pragma unroll yes
+        for (int l = 0; l < LEVELS; l++) {
+            way[LEVELS - 1 - l] = tree[node];
+            node = 2 * node + 1 + (tree[node] ? 1 : 0);
+        }
+        return way;
+    }
+
+    void touch(ac_int < WIDTH, false > way) {
+        int node = 0;
+        #pragma unroll yes
+        for (int l = 0; l < LEVELS; l++) {
+            bool dir = way[LEVELS - 1 - l];
+            tree[node] = !dir; // Point away from the accessed way
+            node = 2 * node + 1 + (dir ? 1 : 0);
+        }
+    }
+
+    void insert(ac_int < WIDTH, false > way) {
+        touch(way);
+    }
+};
+
+// ------------ FIFO
+// Ways are replaced in round-robin order, hits do not change the order.
+template < int WAYS >
+struct fifo_repl_t {
+    static const int WIDTH = repl_way_width < WAYS >::value;
+
+    ac_int < WIDTH, false > next;
+
+    void reset() {
+        next = 0;
+    }
+
+    ac_int < WIDTH, false > victim() {
+        return next;
+    }
+
+    void touch(ac_int < WIDTH, false > way) {
+    }
+
+    void insert(ac_int < WIDTH, false > way) {
+        next = (next == WAYS - 1) ? (ac_int < WIDTH, false >) 0 : (ac_int < WIDTH, false >) (next + 1);
+    }
+};
+
+// ------------ Random
+// A 16-bit Fibonacci LFSR per set (x^16 + x^14 + x^13 + x^11 + 1),
+// advanced on every access of the set.
+template < int WAYS >
+struct random_repl_t {
+    static const int WIDTH = repl_way_width < WAYS >::value;
+
+    ac_int < 16, false > lfsr;
+
+    void reset() {
+        lfsr = 0xACE1;
+    }
+
+    ac_int < WIDTH, false > victim() {
+        ac_int < WIDTH, false > way = lfsr.slc<WIDTH>(0);
+        if (way >= WAYS) {
+            way = way - WAYS;
+        }
+        return way;
+    }
+
+    void step() {
+        bool feedback = lfsr[0] ^ lfsr[2] ^ lfsr[3] ^ lfsr[5];
+        lfsr = lfsr >> 1;
+        lfsr[15] = feedback;
+    }
+
+    void touch(ac_int < WIDTH, false > way) {
+        step();
+    }
+
+    void insert(ac_int < WIDTH, false > way) {
+        step();
+    }
+};
+
+// ------------ SRRIP
+// Static re-reference interval prediction with REPL_RRPV_WIDTH bits per
+// way. Lines are inserted with a long re-reference interval and promoted
+// to near-immediate on a hit.
+template < int WAYS >
+struct srrip_repl_t {
+    static const int WIDTH = repl_way_width < WAYS >::value;
+    static const int RRPV_MAX = (1 << REPL_RRPV_WIDTH) - 1;
+
+    ac_int < REPL_RRPV_WIDTH, false > rrpv[WAYS];
+
+    void reset() {
+        #pragma unroll yes
+        for (int i = 0; i < WAYS; i++) {
+            rrpv[i] = RRPV_MAX;
+        }
+    }
+
+    ac_int < REPL_RRPV_WIDTH, false > max_rrpv() {
+        ac_int < REPL_RRPV_WIDTH, false > max = 0;
+        #pragma unroll yes
+        for (int i = 0; i < WAYS; i++) {
+            if (rrpv[i] > max) {
+                max = rrpv[i];
+            }
+        }
+        return max;
+    }
+
+    // First way with the largest RRPV. The aging that makes it reach
+    // RRPV_MAX is applied by insert().
+    ac_int < WIDTH, false > victim() {
+        ac_int < REPL_RRPV_WIDTH, false > max = max_rrpv();
+        ac_int < WIDTH, false > way = 0;
+        #pragma unroll yes
+        for (int i = WAYS - 1; i >= 0; i--) {
+            if (rrpv[i] == max) {
+                way = i;
+            }
+        }
+        return way;
+    }
+
+    void touch(ac_int < WIDTH, false > way) {
+        rrpv[way] = 0;
+    }
+
+    void insert(ac_int < WIDTH, false > way) {
+        ac_int < REPL_RRPV_WIDTH, false > max = max_rrpv();
+        if (rrpv[way] == max) {
+            ac_int < REPL_RRPV_WIDTH, false > delta = RRPV_MAX - max;
+            #pragma unroll yes
+            for (int i = 0; i < WAYS; i++) {
+                rrpv[i] = rrpv[i] + delta;
+            }
+        }
+        rrpv[way] = RRPV_MAX - 1;
+    }
+};
+
+// ------------ Policy selection
+template < int WAYS, int POLICY >
+struct repl_select;
+
+template < int WAYS >
+struct repl_select < WAYS, REPL_LRU > {
+    typedef lru_repl_t < WAYS > type;
+};
+
+template < int WAYS >
+struct repl_select < WAYS, REPL_PLRU > {
+    typedef plru_repl_t < WAYS > type;
+};
+
+template < int WAYS >
+struct repl_select < WAYS, REPL_FIFO > {
+    typedef fifo_repl_t < WAYS > type;
+};
+
+template < int WAYS >
+struct repl_select < WAYS, REPL_RANDOM > {
+    typedef random_repl_t < WAYS > type;
+};
+
+template < int WAYS >
+struct repl_select < WAYS, REPL_SRRIP > {
+    typedef srrip_repl_t < WAYS > type;
+};
+
+#endif
@@ -0,0 +1,13 @@
+//#include <stddef.h>
+//#include <stdio.h>
+//#include <stdlib.h>
+
+void *custom();
+
+int notmain()
+{
+	
+	custom();
+	
+	return 0;
+}
@@ -0,0 +1,24 @@
+	.text
+	.balign 4
+	.global custom
+
+# Walks a linked list with zero-offset loads, so the base of each load is
+# the result of the previous one. Such a load has the control word of a
+# move (ADDI rd, rs, 0) and must not be eliminated as one. The list is at
+# 0x400, the end of the simulation dumps it as dmem[256..258], and the
+# result is written to dmem[259]: 84 (0x54) when correct.
+custom:
+	li x4, 0x400
+	addi x6, x4, 4
+	addi x7, x4, 8
+	sw x6, 0(x4)
+	sw x7, 0(x6)
+	li x8, 42
+	sw x8, 0(x7)
+	lw x5, 0(x4)
+	lw x5, 0(x5)
+	lw x5, 0(x5)
+	mv x9, x5
+	add x10, x9, x5
+	sw x10, 12(x4)
+	ret
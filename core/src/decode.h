@@ -25,9 +25,11 @@
 #include "drim4hls_datatypes.h"
 #include "defines.h"
 #include "globals.h"
+#include "../../common/compare.h"
+#include "static_prediction.h"
 
 #include <mc_connections.h>
-#include <ac_sysc_macros.h>
+#include <ac_int.h>
 
 SC_MODULE(decode) {
     public:
@@ -56,7 +58,7 @@ SC_MODULE(decode) {
     bool branch;
     // Trap signals. TODO: not used. Left for future implementations.
     sc_signal < bool > CCS_INIT_S1(trap); //sc_out
-    sc_signal < sc_uint < LOG2_NUM_CAUSES > > CCS_INIT_S1(trap_cause); //sc_out
+    sc_signal < ac_int < LOG2_NUM_CAUSES, false > > CCS_INIT_S1(trap_cause); //sc_out
 
     bool freeze;
     // Flushes current instruction in order to sychronize processor with a
@@ -67,22 +69,22 @@ SC_MODULE(decode) {
     bool forward_success_rs2;
 
     bool load_instruction;
-    sc_int < PC_LEN > load_pc;
+    ac_int < PC_LEN, true > load_pc;
 
-    sc_uint < INSN_LEN > insn; // Contains full instruction fetched from IMEM. Used in decoding.
-    sc_int < PC_LEN > pc; // Contains PC for the current instruction that is decoded   
+    ac_int < INSN_LEN, false > insn; // Contains full instruction fetched from IMEM. Used in decoding.
+    ac_int < PC_LEN, true > pc; // Contains PC for the current instruction that is decoded   
     // NB. x0 is included in this regfile so it is not a real hardcoded 0
-    // constant. The writeback section of fedec has a guard fro writes on
-    // x0. For double protection, some instructions that want to write into
-    // x0 will have their regwrite signal forced to false.
-    sc_uint < XLEN > regfile[REG_NUM];
+    // constant. The regwrite signal of every instruction that writes into
+    // x0 is forced to false, so x0 is never written and never stalls its
+    // readers.
+    ac_int < XLEN, false > regfile[REG_NUM];
     // Keeps track of in-flight instructions that are going to overwrite a
     // register. Implements a primitive stall mechanism for RAW hazards.
-    sc_uint < XLEN + 1 > sentinel[REG_NUM];
+    ac_int < XLEN + 1, false > sentinel[REG_NUM];
 
-    sc_uint < TAG_WIDTH > tag;
+    ac_int < TAG_WIDTH, false > tag;
     // Stalls processor and sends a nop operation to the execute stage
-    sc_uint < OPCODE_SIZE > opcode;
+    ac_int < OPCODE_SIZE, false > opcode;
 
     int position;
     // Member variables (DECODE)
@@ -104,8 +106,8 @@ SC_MODULE(decode) {
    
 	bool freeze_tmp;
 	bool flush_tmp;
-	sc_uint < 32 > addr_tmp;
-	sc_uint < 5 > zero_reg_addr;
+	ac_int < 32, false > addr_tmp;
+	ac_int < 5, false > zero_reg_addr;
      
     bool flush_next;
 	
@@ -144,13 +146,13 @@ SC_MODULE(decode) {
         bool rs1_forward;
         bool rs2_forward;
         bool branch_taken;
-        sc_uint < XLEN > rs1;
-        sc_uint < XLEN > rs2;
+        ac_int < XLEN, false > rs1;
+        ac_int < XLEN, false > rs2;
         std::string dest_reg;
         int pc;
         int aligned_pc;
-        sc_uint < XLEN - 12 > imm_u;
-        sc_uint < TAG_WIDTH > tag;
+        ac_int < XLEN - 12, false > imm_u;
+        ac_int < TAG_WIDTH, false > tag;
 
     }
     debug_dout_t;
@@ -165,9 +167,11 @@ SC_MODULE(decode) {
             imem_out.Reset();
             fwd_exe.Reset();
 
-            // Init. sentinel flags to zero.
+            // Init. sentinel flags and registers to zero. Unlike sc_uint,
+            // ac_int is not cleared on construction and x0 must read 0.
             for (int i = 0; i < REG_NUM; i++) {
                 sentinel[i] = SENTINEL_INIT;
+                regfile[i] = 0;
             }
 
             // Program has not completed
@@ -238,10 +242,10 @@ SC_MODULE(decode) {
                     load_instruction = false;
             }
             
-            if (feedinput.regwrite == 1 && feedinput.regfile_address != 0) { // Actual writeback.
+            if (feedinput.regwrite == 1) { // Actual writeback.
                     regfile[feedinput.regfile_address] = feedinput.regfile_data; // Overwrite register.
 
-				if ((feedinput.pc == sentinel[feedinput.regfile_address].range(32, 1)) && (sentinel[feedinput.regfile_address][0] == 1)) {
+				if ((feedinput.pc == sentinel[feedinput.regfile_address].slc<32>(1)) && (sentinel[feedinput.regfile_address][0] == 1)) {
 					sentinel[feedinput.regfile_address][0] = 0;
 				}
 
@@ -271,7 +275,7 @@ SC_MODULE(decode) {
             output.pc = pc;
 
             // Increment some instruction counters
-			opcode = insn.range(6, 2);
+			opcode = insn.slc<OPCODE_SIZE>(2);
             if (!freeze) {
 
                 if (opcode == OPC_LW || opcode == OPC_SW)
@@ -301,12 +305,30 @@ SC_MODULE(decode) {
                 program_end.write(true);
             }
 
-            sc_uint < REG_ADDR > rs1_addr = insn.range(19, 15);
-            sc_uint < REG_ADDR > rs2_addr = insn.range(24, 20);
+            // An ALU operation into x0 or a move of a register onto itself
+            // (ADDI rd, rd, 0) has no effect. It leaves decode as a bubble and
+            // does not wait for its sources.
+            bool nop = false;
+            if (opcode == OPC_ADDI || opcode == OPC_ADD || opcode == OPC_LUI || opcode == OPC_AUIPC) {
+                nop = (insn.slc<REG_ADDR>(7) == 0) ||
+                    (opcode == OPC_ADDI && insn.slc<3>(12) == FUNCT3_ADDI && insn.slc<12>(20) == 0 && insn.slc<REG_ADDR>(7) == insn.slc<REG_ADDR>(15));
+            }
+
+            ac_int < REG_ADDR, false > rs1_addr = insn.slc<REG_ADDR>(15);
+            ac_int < REG_ADDR, false > rs2_addr = insn.slc<REG_ADDR>(20);
+            // Fields that are not register sources read x0, whose sentinel is
+            // never set, so the immediate bits of I-, U- and J-type
+            // instructions do not make up a dependence.
+            if (opcode == OPC_LUI || opcode == OPC_AUIPC || opcode == OPC_JAL || (opcode == OPC_SYSTEM && insn[14] == 1) || nop) {
+                rs1_addr = 0;
+            }
+            if ((opcode != OPC_ADD && opcode != OPC_SB && opcode != OPC_BEQ) || nop) {
+                rs2_addr = 0;
+            }
 			
 			
-			sc_uint< 32 > rs1_sent_pc = sentinel[rs1_addr].range(32, 1);
-			sc_uint < 1 > rs1_sent_valid = sentinel[rs1_addr].range(0, 0);
+			ac_int < 32, false > rs1_sent_pc = sentinel[rs1_addr].slc<32>(1);
+			ac_int < 1, false > rs1_sent_valid = sentinel[rs1_addr].slc<1>(0);
             
             if (!fwd.ldst && fwd.pc == rs1_sent_pc && rs1_sent_valid == 1) {
                 forward_success_rs1 = true;
@@ -328,8 +350,8 @@ SC_MODULE(decode) {
                 
             }
 
-            sc_uint < 32 > rs2_sent_pc = sentinel[rs2_addr].range(32, 1);
-			sc_uint < 1 > rs2_sent_valid = sentinel[rs2_addr].range(0, 0);
+            ac_int < 32, false > rs2_sent_pc = sentinel[rs2_addr].slc<32>(1);
+			ac_int < 1, false > rs2_sent_valid = sentinel[rs2_addr].slc<1>(0);
 			
             if (!fwd.ldst && fwd.pc == rs2_sent_pc && rs2_sent_valid == 1) {
                 forward_success_rs2 = true;
@@ -353,23 +375,34 @@ SC_MODULE(decode) {
             }
             // *** Feedback to fetch data computation and put() section.
             // -- Address sign extensions.
-            sc_uint < 21 > immjal_tmp = ((sc_uint < 1 > ) insn.range(31, 31), (sc_uint < 8 > ) insn.range(19, 12), (sc_uint < 1 > ) insn.range(20, 20), (sc_uint < 10 > ) insn.range(30, 21), (sc_uint < 1 > )(0));
-            sc_uint < 13 > immbranch_tmp = ((sc_uint < 1 > ) insn.range(31, 31), (sc_uint < 1 > ) insn.range(7, 7), (sc_uint < 6 > ) insn.range(30, 25), (sc_uint < 4 > ) insn.range(11, 8), (sc_uint < 1 > )(0));
+            ac_int < 21, false > immjal_tmp;
+            ac_int < 13, false > immbranch_tmp;
+
+            immjal_tmp[0] = 0;
+            immjal_tmp.set_slc(1, insn.slc<10>(21));
+            immjal_tmp[11] = insn[20];
+            immjal_tmp.set_slc(12, insn.slc<8>(12));
+            immjal_tmp[20] = insn[31];
+
+            immbranch_tmp[0] = 0;
+            immbranch_tmp.set_slc(1, insn.slc<4>(8));
+            immbranch_tmp.set_slc(5, insn.slc<6>(25));
+            immbranch_tmp[11] = insn[7];
+            immbranch_tmp[12] = insn[31];
 
             self_feed.branch_address = sign_extend_branch(immbranch_tmp + pc);
             // -- Jump.
-            if (insn.range(6,2) == OPC_JAL) {
+            if (insn.slc<5>(2) == OPC_JAL) {
                 self_feed.jump_address = sign_extend_jump(immjal_tmp + pc);
                 jump = true;
-            } else if (insn.range(6,2) == OPC_JALR) {
-                sc_uint < PC_LEN > extended;
+            } else if (insn.slc<5>(2) == OPC_JALR) {
+                ac_int < PC_LEN, false > extended;
                 if (insn[31] == 0)
                     extended = 0;
                 else
                     extended = 4294967295;
 
-                extended.range(11, 0) = insn.range(31, 20);
-                //extended.set_slc(0, insn.slc<12>(20));
+                extended.set_slc(0, insn.slc<12>(20));
                 self_feed.jump_address = extended + output.rs1;
                 self_feed.jump_address[0] = 0;
                 jump = true;
@@ -379,80 +412,33 @@ SC_MODULE(decode) {
 
             // -- Branch circuitry.
             branch = false;
-            if (insn.range(6,2) == OPC_BEQ) { // BEQ,BNE, BLT, BGE, BLTU, BGEU
-                switch (insn.range(14, 12)) {
-                case FUNCT3_BEQ:
-                    if (output.rs1 == output.rs2)
-						branch = true; // BEQ taken.
-                    #ifndef __SYNTHESIS__
-                    debug_dout_t.branch_taken = true;
-                    #endif
-
-                    break;
-                case FUNCT3_BNE:
-                    if (output.rs1 != output.rs2) {
-						branch = true; //BNE taken.
-                        #ifndef __SYNTHESIS__
-                        debug_dout_t.branch_taken = true;
-                        #endif
-                    }
-                    break;
-                case FUNCT3_BLT:
-                    if (output.rs1 < output.rs2) {
-						branch = true; // BLT taken
-                        #ifndef __SYNTHESIS__
-                        debug_dout_t.branch_taken = true;
-                        #endif
-                    }
-                    break;
-                case FUNCT3_BGE:
-                    if (output.rs1 >= output.rs2) {
-						branch = true; // BGE taken.
-                        #ifndef __SYNTHESIS__
-                        debug_dout_t.branch_taken = true;
-                        #endif
-                    }
-                    break;
-                case FUNCT3_BLTU:
-                    if (output.rs1 < output.rs2) {
-						branch = true; // BLTU taken.
-                        #ifndef __SYNTHESIS__
-                        debug_dout_t.branch_taken = true;
-                        #endif
-                    }
-                    break;
-                case FUNCT3_BGEU:
-                    if (output.rs1 >= output.rs2) {
-						branch = true; // BGEU taken.
-                        #ifndef __SYNTHESIS__
-                        debug_dout_t.branch_taken = true;
-                        #endif
-                    }
-                    break;
-                default:
-                    branch = false; // default to not taken.
-                    #ifndef __SYNTHESIS__
-                    debug_dout_t.branch_taken = false;
-                    #endif
-                    break;
-                }
+            if (insn.slc<5>(2) == OPC_BEQ) { // BEQ,BNE, BLT, BGE, BLTU, BGEU
+                branch = branch_taken(compare(output.rs1, output.rs2), insn.slc<3>(12));
+                #ifndef __SYNTHESIS__
+                debug_dout_t.branch_taken = branch;
+                #endif
             }
+            // -- Static prediction made by fetch for this instruction.
+            ac_int < PC_LEN, false > predicted_next = pc + 4;
+            #ifdef STATIC_PREDICTION
+            predicted_next = static_prediction(pc, insn);
+            #endif
             // -- All data for feedback path to fetch is ready now. Do put(): in this version it saved data in self_feed.
             // *** END of feedback to fetch data computation and put() section.
 
             // *** Propagations: rd, immediates sign extensions.
-            output.dest_reg = insn.range(11, 7);
+            output.dest_reg = insn.slc<5>(7);
             // RD field of insn.
-            output.imm_u = insn.range(31, 12); // This field is then used in the execute stage not only as immU field but to obtain several subfields used by non U-type instructions.
+            output.imm_u = insn.slc<20>(12); // This field is then used in the execute stage not only as immU field but to obtain several subfields used by non U-type instructions.
 
             #ifndef __SYNTHESIS__
-            debug_dout_t.dest_reg = std::to_string(insn.range(11,7).to_int());
-            debug_dout_t.imm_u = insn.range(31, 12);
+            debug_dout_t.dest_reg = std::to_string(insn.slc<5>(7).to_int());
+            debug_dout_t.imm_u = insn.slc<20>(12);
             #endif
             // *** END of RD propagation and immediates sign extensions.
 
             // *** Control word generation.
-            switch (insn.range(6, 2)) { // Opcode's 2 LSBs have been trimmed to save area.
+            switch (insn.slc<5>(2)) { // Opcode's 2 LSBs have been trimmed to save area.
 
             case OPC_LUI:
                 output.alu_op = ALUOP_LUI;
@@ -555,7 +541,7 @@ SC_MODULE(decode) {
                 break;
 
             case OPC_LW:
-                switch (insn.range(14, 12)) {
+                switch (insn.slc<3>(12)) {
                 case FUNCT3_LB:
                     output.ld = LB_LOAD;
 
@@ -618,7 +604,7 @@ SC_MODULE(decode) {
                 break;
 
             case OPC_SW:
-                switch (insn.range(14, 12)) {
+                switch (insn.slc<3>(12)) {
                 case FUNCT3_SB:
                     output.st = SB_STORE;
                     #ifndef __SYNTHESIS__
@@ -664,7 +650,7 @@ SC_MODULE(decode) {
 
             case OPC_ADDI: // OP-IMM instructions (arithmetic and logical operations on immediates): ADDI, SLTI, SLTIU, XORI, ORI, ANDI, SLLI, SRLI, SRAI
 
-                if (insn.range(31, 25) == FUNCT7_SRAI && insn.range(14, 12) == FUNCT3_SRAI) {
+                if (insn.slc<7>(25) == FUNCT7_SRAI && insn.slc<3>(12) == FUNCT3_SRAI) {
                     output.alu_op = ALUOP_SRAI;
                     output.alu_src = ALUSRC_IMM_U;
 
@@ -672,7 +658,7 @@ SC_MODULE(decode) {
                     debug_dout_t.alu_op = "ALUOP_SRAI";
                     debug_dout_t.alu_src = "ALUSRC_IMM_U";
                     #endif
-                } else if (insn.range(31, 25) == FUNCT7_SLLI && insn.range(14, 12) == FUNCT3_SLLI) {
+                } else if (insn.slc<7>(25) == FUNCT7_SLLI && insn.slc<3>(12) == FUNCT3_SLLI) {
                     output.alu_op = ALUOP_SLLI;
                     output.alu_src = ALUSRC_IMM_U;
 
@@ -680,7 +666,7 @@ SC_MODULE(decode) {
                     debug_dout_t.alu_op = "ALUOP_SLLI";
                     debug_dout_t.alu_src = "ALUSRC_IMM_U";
                     #endif
-                } else if (insn.range(31, 25) == FUNCT7_SRLI && insn.range(14, 12) == FUNCT3_SRLI) {
+                } else if (insn.slc<7>(25) == FUNCT7_SRLI && insn.slc<3>(12) == FUNCT3_SRLI) {
                     output.alu_op = ALUOP_SRLI;
                     output.alu_src = ALUSRC_IMM_U;
 
@@ -694,7 +680,7 @@ SC_MODULE(decode) {
                     #ifndef __SYNTHESIS__
                     debug_dout_t.alu_src = "ALUSRC_IMM_I";
                     #endif
-                    switch (insn.range(14, 12)) {
+                    switch (insn.slc<3>(12)) {
                     case FUNCT3_ADDI:
                         output.alu_op = ALUOP_ADDI;
 
@@ -779,9 +765,9 @@ SC_MODULE(decode) {
                 debug_dout_t.memtoreg = "REGWRITE NO";
                 #endif
                 // FUNCT7 switch discriminates between classes of R-type instructions.
-                switch (insn.range(31, 25)) {
+                switch (insn.slc<7>(25)) {
                 case FUNCT7_ADD: // ADD, SLL, SLT, SLTU, XOR, SRL, OR, AND
-                    switch (insn.range(14, 12)) {
+                    switch (insn.slc<3>(12)) {
                     case FUNCT3_ADD:
                         output.alu_op = ALUOP_ADD;
 
@@ -849,7 +835,7 @@ SC_MODULE(decode) {
                     }
                     break;
                 case FUNCT7_SUB: // SUB, SRA
-                    switch (insn.range(14, 12)) {
+                    switch (insn.slc<3>(12)) {
                     case FUNCT3_SUB:
                         output.alu_op = ALUOP_SUB;
 
@@ -876,7 +862,7 @@ SC_MODULE(decode) {
                     break;
                     #if defined(MUL32) || defined(MUL64) || defined(DIV) || defined(REM)
                 case FUNCT7_MUL: // MUL, MULH, MULHSU, MULHU, DIV, DIVU, REM, REMU
-                    switch (insn.range(14, 12)) {
+                    switch (insn.slc<3>(12)) {
                     case FUNCT3_MUL:
                         output.alu_op = ALUOP_MUL;
 
@@ -972,32 +958,32 @@ SC_MODULE(decode) {
                 debug_dout_t.memtoreg = "MEMTOREG NO";
                 debug_dout_t.regwrite = "REGWRITE YES";
                 #endif
-                switch (insn.range(14, 12)) {
+                switch (insn.slc<3>(12)) {
                 case FUNCT3_EBREAK: // EBREAK, ECALL
                     output.regwrite = 0;
                     trap = 1;
                     output.alu_op = ALUOP_CSRRWI;
-                    output.imm_u.range(19, 8) = (sc_uint<CSR_ADDR>) MCAUSE_A; // force the CSR address to MCAUSE's
+                    output.imm_u.set_slc(8, (ac_int < CSR_ADDR, false >) MCAUSE_A); // force the CSR address to MCAUSE's
 
                     #ifndef __SYNTHESIS__
                     debug_dout_t.alu_op = "ALUOP_CSRRWI";
-                    debug_dout_t.imm_u.range(19, 8) = (sc_uint<CSR_ADDR>)MCAUSE_A;
+                    debug_dout_t.imm_u.set_slc(8, (ac_int < CSR_ADDR, false >) MCAUSE_A);
                     #endif
                     if (insn[20] == FUNCT7_EBREAK) { // Bit 20 discriminates b/n EBREAK and ECALL
                         // EBREAK and ECALL leverage CSRRWI decoding to write into the MCAUSE register
                         // but keep regwrite to "0" to prevent writeback
                         trap_cause = EBREAK_CAUSE; // may be not necessary but is kept for future implementations
-                        output.imm_u.range(5, 3) = (sc_uint<3>) EBREAK_CAUSE; // force the exception cause on the zimm field
+                        output.imm_u.set_slc(3, (ac_int < 3, false >) EBREAK_CAUSE); // force the exception cause on the zimm field
 
                         #ifndef __SYNTHESIS__
-                        debug_dout_t.imm_u.range(5, 3) = (sc_uint<3>) EBREAK_CAUSE;
+                        debug_dout_t.imm_u.set_slc(3, (ac_int < 3, false >) EBREAK_CAUSE);
                         #endif
                     } else { // FUNCT7_ECALL
                         trap_cause = ECALL_CAUSE; // may be not necessary but is kept for future implementations
-                        output.imm_u.range(7, 3) = (sc_uint<ZIMM_SIZE>) ECALL_CAUSE; // force the exception cause on the zimm field
+                        output.imm_u.set_slc(3, (ac_int < ZIMM_SIZE, false >) ECALL_CAUSE); // force the exception cause on the zimm field
 
                         #ifndef __SYNTHESIS__
-                        debug_dout_t.imm_u.range(7, 3) = (sc_uint<ZIMM_SIZE>) ECALL_CAUSE;
+                        debug_dout_t.imm_u.set_slc(3, (ac_int < ZIMM_SIZE, false >) ECALL_CAUSE);
                         #endif
                     }
                     break;
@@ -1080,7 +1066,7 @@ SC_MODULE(decode) {
                 trap = 1;
                 trap_cause = ILL_INSN_CAUSE;
                 output.alu_op = ALUOP_CSRRWI;
-                output.imm_u.range(19, 8) = (sc_uint<CSR_ADDR>)MCAUSE_A; // force the CSR address to MCAUSE's
+                output.imm_u.set_slc(8, (ac_int < CSR_ADDR, false >) MCAUSE_A); // force the CSR address to MCAUSE's
 
                 #ifndef __SYNTHESIS__
                 debug_dout_t.alu_src = "ALUSRC_RS2";
@@ -1089,51 +1075,63 @@ SC_MODULE(decode) {
                 debug_dout_t.st = "NO_STORE";
                 debug_dout_t.memtoreg = "MEMTOREG NO";
                 debug_dout_t.alu_op = "ALUOP_CSRRWI";
-                debug_dout_t.imm_u.range(19, 8) = (sc_uint<CSR_ADDR>)MCAUSE_A;
-                debug_dout_t.imm_u.range(7,3) = (sc_uint<5>)ILL_INSN_CAUSE;
+                debug_dout_t.imm_u.set_slc(8, (ac_int < CSR_ADDR, false >) MCAUSE_A);
+                debug_dout_t.imm_u.set_slc(3, (ac_int < 5, false >) ILL_INSN_CAUSE);
                 #endif
                 
                 SC_REPORT_ERROR(sc_object::name(), "Unimplemented instruction");
                 break;
             } // --- END of OPCODE switch
+            // Results written to x0 are dropped here, so x0 producers never
+            // set a sentinel and writeback never sees them
+            if (output.dest_reg == 0) {
+                output.regwrite = 0;
+            }
             // *** END of control word generation.
-            sc_uint <1> sen1_test = sentinel[rs1_addr].range(0, 0);
-            sc_uint <1> sen2_test = sentinel[rs2_addr].range(0, 0);
+            ac_int < 1, false > sen1_test = sentinel[rs1_addr].slc<1>(0);
+            ac_int < 1, false > sen2_test = sentinel[rs2_addr].slc<1>(0);
 
             if ((sen1_test && !forward_success_rs1) || (sen2_test && !forward_success_rs2) || load_instruction) {
                 freeze = true;
                 fetch_out.freeze = true;
                 flush = false;
-                fetch_out.address = pc + 4;
+                fetch_out.address = predicted_next;
 				
             } else if(flush_next) {				
 				fetch_out.freeze = false;
 				fetch_out.redirect = false;
 								
-			} else if ((jump) && !flush && self_feed.jump_address != pc + 4) {
+			} else if ((jump) && !flush && self_feed.jump_address != predicted_next) {
                 freeze = true;
                 fetch_out.freeze = false;
                 flush = true;
                 fetch_out.address = self_feed.jump_address;
                 fetch_out.redirect = true;
 				                
-            } else if ((branch) && !flush && self_feed.branch_address != pc + 4) {
+            } else if ((branch) && !flush && self_feed.branch_address != predicted_next) {
                 freeze = true;
                 fetch_out.freeze = false;
                 flush = true;
                 fetch_out.address = self_feed.branch_address;
                 fetch_out.redirect = true;
 				                
+            } else if (!(branch) && !(jump) && !flush && predicted_next != pc + 4) { // backward branch not taken
+                freeze = true;
+                fetch_out.freeze = false;
+                flush = true;
+                fetch_out.address = pc + 4;
+                fetch_out.redirect = true;
+				                
             } else {
                 freeze = false;
                 flush = false;
             }
 			
-            sc_uint < 1 > out_regwrite = output.regwrite;
-            sc_uint < 33 > sen_input;
+            ac_int < 1, false > out_regwrite = output.regwrite;
+            ac_int < 33, false > sen_input;
             
-            if (!freeze && output.regwrite[0] == 1 && output.dest_reg != 0) {
-                sentinel[output.dest_reg].range(32, 1) = pc; // Set corresponding sentinel flag.
+            if (!freeze && output.regwrite[0] == 1) {
+                sentinel[output.dest_reg].set_slc(1, (ac_int < 32, false >) pc); // Set corresponding sentinel flag.
                 sentinel[output.dest_reg][0] = 1;
 
                 if (output.dest_reg == rs1_addr) {
@@ -1144,7 +1142,7 @@ SC_MODULE(decode) {
             }
 
             // *** Transform instruction into nop when freeze is active
-            if (freeze || insn == 0 || flush_next) {
+            if (freeze || insn == 0 || nop || flush_next) {
                 // Bubble.
                 output.regwrite = 0;
                 output.ld = NO_LOAD;
@@ -1210,28 +1208,28 @@ SC_MODULE(decode) {
     // --- Utility functions.
 
     // Sign extend UJ insn.
-    sc_uint < PC_LEN > sign_extend_jump(sc_uint < 21 > imm) {
+    ac_int < PC_LEN, false > sign_extend_jump(ac_int < 21, false > imm) {
         if (imm[20] == 1) {
-			sc_uint < 32 > ext_imm = 4294967295;
-            ext_imm.range(20, 0) = imm;
+			ac_int < 32, false > ext_imm = 4294967295;
+            ext_imm.set_slc(0, imm);
             return ext_imm;
         }
         else {
-			sc_uint < 32 > ext_imm = imm;
+			ac_int < 32, false > ext_imm = imm;
 			return ext_imm;
 		}
     }
 
     // Sign extend branch insn.
-    sc_uint < PC_LEN > sign_extend_branch(sc_uint < 13 > imm) {
+    ac_int < PC_LEN, false > sign_extend_branch(ac_int < 13, false > imm) {
         
         if (imm[12] == 1) {
-			sc_uint < 32 > ext_imm = 4294967295;
-            ext_imm.range(12, 0) = imm;
+			ac_int < 32, false > ext_imm = 4294967295;
+            ext_imm.set_slc(0, imm);
             return ext_imm;
         }
         else {
-			sc_uint < 32 > ext_imm = imm;
+			ac_int < 32, false > ext_imm = imm;
 			return ext_imm;
 		}
     }
@@ -29,6 +29,8 @@
 #define SENTINEL_INIT (1 << (TAG_WIDTH - 1))
 #define FWD_ENABLE
 
+#define STATIC_PREDICTION 1 // Fetch follows JALs and backward branches (BTFN), decode redirects only on a wrong guess
+
 // Dbg directives.
 
 #define INTERNAL_PROG // When on specifies the program to execute as an array in the fetch stage (not for production).
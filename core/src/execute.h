@@ -32,17 +32,17 @@
 #include "globals.h"
 
 #include <mc_connections.h>
-#include <ac_sysc_macros.h>
+#include <ac_int.h>
 // Signed division quotient and remainder struct.
 struct div_res_t {
-    sc_int < XLEN > quotient;
-    sc_int < XLEN > remainder;
+    ac_int < XLEN, true > quotient;
+    ac_int < XLEN, true > remainder;
 };
 
 // Unsigned division quotient and remainder struct.
 struct u_div_res_t {
-    sc_uint < XLEN > quotient;
-    sc_uint < XLEN > remainder;
+    ac_int < XLEN, false > quotient;
+    ac_int < XLEN, false > remainder;
 };
 
 SC_MODULE(execute) {
@@ -53,14 +53,14 @@ SC_MODULE(execute) {
         //
         // Member declarations.
         //
-        sc_bv < 3 > ld;
-        sc_bv < 2 > st;
-        sc_bv < 1 > memtoreg;
-        sc_bv < 1 > regwrite;
-        sc_bv < XLEN > alu_res;
-        sc_bv < DATA_SIZE > mem_datain;
-        sc_bv < REG_ADDR > dest_reg;
-        sc_uint < TAG_WIDTH > tag;
+        ac_int < 3, false > ld;
+        ac_int < 2, false > st;
+        ac_int < 1, false > memtoreg;
+        ac_int < 1, false > regwrite;
+        ac_int < XLEN, false > alu_res;
+        ac_int < DATA_SIZE, false > mem_datain;
+        ac_int < REG_ADDR, false > dest_reg;
+        ac_int < TAG_WIDTH, false > tag;
         std::string alu_src;
         std::string alu_op;
 
@@ -84,7 +84,7 @@ SC_MODULE(execute) {
     dmem_in_t dmem_din;
     reg_forward_t forward;
 
-    sc_uint < XLEN > csr[CSR_NUM]; // Control and status registers.
+    ac_int < XLEN, false > csr[CSR_NUM]; // Control and status registers.
     bool freeze;
    
     // Constructor
@@ -94,20 +94,20 @@ SC_MODULE(execute) {
         async_reset_signal_is(rst, false);
     }
 
-    u_div_res_t udiv_func(sc_uint < XLEN > num, sc_uint < XLEN > den) {
-        sc_uint < XLEN > rem;
-        sc_uint < XLEN > quotient;
+    u_div_res_t udiv_func(ac_int < XLEN, false > num, ac_int < XLEN, false > den) {
+        ac_int < XLEN, false > rem;
+        ac_int < XLEN, false > quotient;
         u_div_res_t u_div_res;
 
         rem = 0;
         quotient = 0;
 
         DIVIDE_LOOP:
-            for (sc_int < 6 > i = 31; i >= 0; i--) {
+            for (ac_int < 6, true > i = 31; i >= 0; i--) {
                 // Break EXE stage protocol for DSE
 
-                const sc_uint < XLEN > mask = BIT(i);
-                const sc_uint < XLEN > lsb = (mask & num) >> i;
+                const ac_int < XLEN, false > mask = BIT(i);
+                const ac_int < XLEN, false > lsb = (mask & num) >> i;
 
                 rem = rem << 1;
                 rem = rem | lsb;
@@ -125,7 +125,7 @@ SC_MODULE(execute) {
         return u_div_res;
     }
 
-    div_res_t div_func(sc_int < XLEN > num, sc_int < XLEN > den) {
+    div_res_t div_func(ac_int < XLEN, true > num, ac_int < XLEN, true > den) {
         bool num_neg;
         bool den_neg;
         div_res_t div_res;
@@ -139,9 +139,9 @@ SC_MODULE(execute) {
         if (den_neg)
             den = -den;
 
-        u_div_res = udiv_func((sc_uint < XLEN > ) num, (sc_uint < XLEN > ) den);
-        div_res.quotient = (sc_int < XLEN > ) u_div_res.quotient;
-        div_res.remainder = (sc_int < XLEN > ) u_div_res.remainder;
+        u_div_res = udiv_func((ac_int < XLEN, false > ) num, (ac_int < XLEN, false > ) den);
+        div_res.quotient = (ac_int < XLEN, true > ) u_div_res.quotient;
+        div_res.remainder = (ac_int < XLEN, true > ) u_div_res.remainder;
 
         if (num_neg ^ den_neg)
             div_res.quotient = -div_res.quotient;
@@ -195,7 +195,7 @@ SC_MODULE(execute) {
             }
             #ifdef MUL64
             // 64-bit temporary multiplication result, for upper 32 bit multiplications (MULH, MULHU, MULHSU).
-            sc_uint <64> tmp_mul_res = 0;
+            ac_int < 64, false > tmp_mul_res = 0;
             #endif
             #ifdef DIV
             // Temporary division results.
@@ -210,22 +210,21 @@ SC_MODULE(execute) {
             #endif
             #ifdef CSR_LOGIC
             // Temporary CSR index
-            sc_uint < CSR_IDX_LEN > csr_index = 0;
+            ac_int < CSR_IDX_LEN, false > csr_index = 0;
             #endif
 
             // Sign extend the immediate operand for I-type instructions.
-            sc_uint < XLEN > tmp_sigext_imm_i = 0;
+            ac_int < XLEN, false > tmp_sigext_imm_i = 0;
+            tmp_sigext_imm_i.set_slc(0, input.imm_u.slc<12>(8));
             if (input.imm_u[19] == 1) {
                 // Extend with 1s
-                tmp_sigext_imm_i = (sc_uint < 20 > (1048575), (sc_uint < 12 > ) input.imm_u.range(19, 8));
-            } else {
-                // Extend with 0s
-                tmp_sigext_imm_i = (sc_uint < 20 > (0), (sc_uint < 12 > ) input.imm_u.range(19, 8));
+                tmp_sigext_imm_i.set_slc(12, (ac_int < 20, false >) 1048575);
             }
             // Zero-fill the immediate operand for U-type instructions.
-            sc_uint < XLEN > tmp_zerofill_imm_u = ((sc_uint < 20 > ) input.imm_u.range(19, 0), sc_uint < 12 > (0));
+            ac_int < XLEN, false > tmp_zerofill_imm_u = 0;
+            tmp_zerofill_imm_u.set_slc(12, input.imm_u.slc<20>(0));
             // ALU 2nd operand multiplexing based on ALUSRC signal.
-            sc_uint < XLEN > tmp_rs2 = 0;
+            ac_int < XLEN, false > tmp_rs2 = 0;
 
             if (input.alu_src == ALUSRC_RS2) {
                 tmp_rs2 = input.rs2;
@@ -243,7 +242,9 @@ SC_MODULE(execute) {
 
             } else if (input.alu_src == ALUSRC_IMM_S) {
                 // reconstructs imm_s from imm_u and rd
-                sc_uint < 12 > imm_s = (sc_uint < 7 > (input.imm_u.range(19, 13)), input.dest_reg);
+                ac_int < 12, false > imm_s;
+                imm_s.set_slc(0, input.dest_reg);
+                imm_s.set_slc(5, input.imm_u.slc<7>(13));
                 tmp_rs2 = sign_extend_imm_s(imm_s);
 
                 #ifndef __SYNTHESIS__
@@ -262,7 +263,7 @@ SC_MODULE(execute) {
             // ALU body
             switch (input.alu_op) {
             case ALUOP_ADD: // ADD, ADDI, SB, SH, SW, LB, LH, LW, LBU, LHU.
-                output.alu_res = (sc_uint<32>) input.rs1.to_int() + tmp_rs2.to_int();
+                output.alu_res = (ac_int < 32, false >) input.rs1.to_int() + tmp_rs2.to_int();
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_ADD";
@@ -270,7 +271,7 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_SLT: // SLT, SLTI
-                if ((sc_int<32>) input.rs1 < (sc_int<32>) tmp_rs2)
+                if ((ac_int < 32, true >) input.rs1 < (ac_int < 32, true >) tmp_rs2)
                     output.alu_res = 1;
                 else
                     output.alu_res = 0;
@@ -281,7 +282,7 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_SLTU: // SLTU, SLTIU
-                if ((sc_int<32>) input.rs1  < (sc_int<32>) tmp_rs2)
+                if ((ac_int < 32, true >) input.rs1  < (ac_int < 32, true >) tmp_rs2)
                     output.alu_res = 1;
                 else
                     output.alu_res = 0;
@@ -316,7 +317,7 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_SLL: // SLL
-                output.alu_res = (sc_uint < XLEN >) input.rs1 << (sc_uint < SHAMT >) tmp_rs2.range(4, 0);
+                output.alu_res = (ac_int < XLEN, false >) input.rs1 << (ac_int < SHAMT, false >) tmp_rs2.slc<SHAMT>(0);
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_SLL";
@@ -324,7 +325,7 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_SRL: // SRL
-                output.alu_res = (sc_uint < XLEN >) input.rs1 >> (sc_uint < SHAMT >) tmp_rs2.range(4, 0);
+                output.alu_res = (ac_int < XLEN, false >) input.rs1 >> (ac_int < SHAMT, false >) tmp_rs2.slc<SHAMT>(0);
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_SRL";
@@ -332,8 +333,8 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_SRA: // SRA
-                // >> is arith right sh. for sc_int operand
-                output.alu_res = (sc_int < XLEN >) input.rs1 >> (sc_uint < SHAMT >) tmp_rs2.range(4, 0);
+                // >> is arith right sh. for signed ac_int operand
+                output.alu_res = (ac_int < XLEN, true >) input.rs1 >> (ac_int < SHAMT, false >) tmp_rs2.slc<SHAMT>(0);
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_SRA";
@@ -341,7 +342,7 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_SUB: // SUB
-                output.alu_res = (sc_uint < XLEN >) ((sc_int < XLEN >) input.rs1 - (sc_int < XLEN >) tmp_rs2);
+                output.alu_res = (ac_int < XLEN, false >) ((ac_int < XLEN, true >) input.rs1 - (ac_int < XLEN, true >) tmp_rs2);
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_SUB";
@@ -349,7 +350,7 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_SLLI: // SLLI
-                output.alu_res = (sc_uint < XLEN >) input.rs1 << (sc_uint < SHAMT >) tmp_rs2.range(24, 20);
+                output.alu_res = (ac_int < XLEN, false >) input.rs1 << (ac_int < SHAMT, false >) tmp_rs2.slc<SHAMT>(20);
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_SLLI";
@@ -357,7 +358,7 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_SRLI: // SRLI
-                output.alu_res = (sc_uint < XLEN >) input.rs1 >> (sc_uint < SHAMT >) tmp_rs2.range(24, 20);
+                output.alu_res = (ac_int < XLEN, false >) input.rs1 >> (ac_int < SHAMT, false >) tmp_rs2.slc<SHAMT>(20);
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_SRLI";
@@ -365,8 +366,8 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_SRAI: // SRAI
-                // >> is arith right sh. for sc_int operand
-                output.alu_res = (sc_int < XLEN >) input.rs1 >> (sc_uint < SHAMT >) tmp_rs2.range(24, 20);
+                // >> is arith right sh. for signed ac_int operand
+                output.alu_res = (ac_int < XLEN, true >) input.rs1 >> (ac_int < SHAMT, false >) tmp_rs2.slc<SHAMT>(20);
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_SRAI";
@@ -384,7 +385,7 @@ SC_MODULE(execute) {
                 break;
             case ALUOP_AUIPC: // AUIPC
                 // zerofill_imm_u + pc
-                output.alu_res = (sc_int < XLEN >) tmp_rs2 + (sc_int < XLEN >) input.pc;
+                output.alu_res = (ac_int < XLEN, true >) tmp_rs2 + (ac_int < XLEN, true >) input.pc;
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_AUIPC";
@@ -393,7 +394,7 @@ SC_MODULE(execute) {
                 break;
             case ALUOP_JAL: // JAL, JALR
                 // link register update
-                output.alu_res = (sc_int < XLEN >) input.pc + 4;
+                output.alu_res = (ac_int < XLEN, true >) input.pc + 4;
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_JAL";
@@ -402,7 +403,7 @@ SC_MODULE(execute) {
                 break;
                 #ifdef MUL32
             case ALUOP_MUL: // MUL: signed * signed, return lower 32 bits
-                output.alu_res = (sc_int < XLEN >) input.rs1 * (sc_int < XLEN >) tmp_rs2;
+                output.alu_res = (ac_int < XLEN, true >) input.rs1 * (ac_int < XLEN, true >) tmp_rs2;
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_MUL";
@@ -412,8 +413,8 @@ SC_MODULE(execute) {
                 #endif
                 #ifdef MUL64
             case ALUOP_MULH: // MULH: signed * signed, return upper 32 bits
-                tmp_mul_res = input.rs1.to_int() * tmp_rs2.to_int();
-                output.alu_res = sc_uint < XLEN * 2 > (sc_int < XLEN * 2 > (tmp_mul_res)).range((XLEN * 2) - 1, XLEN);
+                tmp_mul_res = (ac_int < XLEN, true >) input.rs1 * (ac_int < XLEN, true >) tmp_rs2;
+                output.alu_res = tmp_mul_res.slc<XLEN>(XLEN);
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_MULH";
@@ -421,8 +422,8 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_MULHSU: // MULHSU: signed * unsigned, return upper 32 bits
-                tmp_mul_res = input.rs1 * tmp_rs2.to_uint();
-                output.alu_res = sc_uint < XLEN * 2 > (sc_int < XLEN * 2 > (tmp_mul_res)).range((XLEN * 2) - 1, XLEN);
+                tmp_mul_res = (ac_int < XLEN, true >) input.rs1 * (ac_int < XLEN, false >) tmp_rs2;
+                output.alu_res = tmp_mul_res.slc<XLEN>(XLEN);
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_MULHSU";
@@ -430,8 +431,8 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_MULHU: // MULHU: unsigned * unsigned, return upper 32 bits
-                tmp_mul_res = input.rs1.to_int() * tmp_rs2.to_uint();
-                output.alu_res = sc_uint < XLEN * 2 > (sc_int < XLEN * 2 > (tmp_mul_res)).range((XLEN * 2) - 1, XLEN);
+                tmp_mul_res = (ac_int < XLEN, false >) input.rs1 * (ac_int < XLEN, false >) tmp_rs2;
+                output.alu_res = tmp_mul_res.slc<XLEN>(XLEN);
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_MULHU";
@@ -441,7 +442,7 @@ SC_MODULE(execute) {
                 #endif
                 #ifdef DIV
             case ALUOP_DIV: // DIV calls div_func
-                div_res = div_func((sc_int < XLEN >) input.rs1, (sc_int < XLEN >) tmp_rs2);
+                div_res = div_func((ac_int < XLEN, true >) input.rs1, (ac_int < XLEN, true >) tmp_rs2);
                 output.alu_res = div_res.quotient;
 
                 #ifndef __SYNTHESIS__
@@ -461,7 +462,7 @@ SC_MODULE(execute) {
                 #endif
                 #ifdef REM
             case ALUOP_REM: // REM calls div_func
-                div_res = div_func((sc_int < XLEN >) input.rs1, (sc_int < XLEN >) tmp_rs2);
+                div_res = div_func((ac_int < XLEN, true >) input.rs1, (ac_int < XLEN, true >) tmp_rs2);
                 output.alu_res = div_res.remainder;
 
                 #ifndef __SYNTHESIS__
@@ -484,9 +485,9 @@ SC_MODULE(execute) {
                 // This avoids having 12 more bits on the FEDEC-EXE Flex Channel.
                 // The same goes for imm_u[7:3] i.e. zimm for the 3 CSRxI instructions.
             case ALUOP_CSRRW: // CSRRW
-                csr_index = get_csr_index(input.imm_u.range(19, 8));
+                csr_index = get_csr_index(input.imm_u.slc<12>(8));
                 output.alu_res = csr[csr_index];
-                set_csr_value(csr_index, input.rs1.to_uint(), CSR_OP_WR, input.imm_u.range(19, 18).to_uint());
+                set_csr_value(csr_index, input.rs1.to_uint(), CSR_OP_WR, input.imm_u.slc<2>(18).to_uint());
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_CSRRW";
@@ -494,9 +495,9 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_CSRRS: // CSRRS
-                csr_index = get_csr_index(input.imm_u.range(19, 8));
+                csr_index = get_csr_index(input.imm_u.slc<12>(8));
                 output.alu_res = csr[csr_index];
-                set_csr_value(csr_index, input.rs1.to_uint(), CSR_OP_SET, input.imm_u.range(19, 18).to_uint());
+                set_csr_value(csr_index, input.rs1.to_uint(), CSR_OP_SET, input.imm_u.slc<2>(18).to_uint());
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_CSRRS";
@@ -504,9 +505,9 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_CSRRC: // CSRRC
-                csr_index = get_csr_index(input.imm_u.range(19, 8));
+                csr_index = get_csr_index(input.imm_u.slc<12>(8));
                 output.alu_res = csr[csr_index];
-                set_csr_value(csr_index, input.rs1.to_uint(), CSR_OP_CLR, input.imm_u.range(19, 8).to_uint());
+                set_csr_value(csr_index, input.rs1.to_uint(), CSR_OP_CLR, input.imm_u.slc<12>(8).to_uint());
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_CSRRC";
@@ -514,9 +515,9 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_CSRRWI: // CSRRWI
-                csr_index = get_csr_index(input.imm_u.range(19, 8));
+                csr_index = get_csr_index(input.imm_u.slc<12>(8));
                 output.alu_res = csr[csr_index];
-                set_csr_value(csr_index, input.imm_u.range(7, 3).to_uint(), CSR_OP_WR, input.imm_u.range(19, 18).to_uint());
+                set_csr_value(csr_index, input.imm_u.slc<5>(3).to_uint(), CSR_OP_WR, input.imm_u.slc<2>(18).to_uint());
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_CSRRWI";
@@ -524,9 +525,9 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_CSRRSI: // CSRRSI
-                csr_index = get_csr_index(input.imm_u.range(19, 8));
+                csr_index = get_csr_index(input.imm_u.slc<12>(8));
                 output.alu_res = csr[csr_index];
-                set_csr_value(csr_index, input.imm_u.range(7, 3).to_uint(), CSR_OP_SET, input.imm_u.range(19, 18).to_uint());
+                set_csr_value(csr_index, input.imm_u.slc<5>(3).to_uint(), CSR_OP_SET, input.imm_u.slc<2>(18).to_uint());
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_CSRRSI";
@@ -534,9 +535,9 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_CSRRCI: // CSRRCI
-                csr_index = get_csr_index(input.imm_u.range(19, 8));
+                csr_index = get_csr_index(input.imm_u.slc<12>(8));
                 output.alu_res = csr[csr_index];
-                set_csr_value(csr_index, input.imm_u.range(7, 3), CSR_OP_CLR, input.imm_u.range(19, 18));
+                set_csr_value(csr_index, input.imm_u.slc<5>(3), CSR_OP_CLR, input.imm_u.slc<2>(18));
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_CSRRCI";
@@ -601,26 +602,26 @@ SC_MODULE(execute) {
     /* Support functions */
 
     // Sign extend immS.
-    sc_uint < XLEN > sign_extend_imm_s(sc_uint < 12 > imm) {
-        sc_uint <XLEN> imm_ext = 0;
+    ac_int < XLEN, false > sign_extend_imm_s(ac_int < 12, false > imm) {
+        ac_int < XLEN, false > imm_ext = 0;
+        imm_ext.set_slc(0, imm);
         if (imm[11] == 1) {
 			// Extend with 1s
-            return (sc_uint < 20 > (1048575), imm);
-        }
-        else { 
-			// Extend with 0s
-			return (sc_uint < 20 > (0), imm);
+            imm_ext.set_slc(12, (ac_int < 20, false >) 1048575);
         }
+        return imm_ext;
     }
 
     #ifdef CSR_LOGIC
     // Zero extends the zimm immediate field of CSRRWI, CSRRSI, CSRRCI
-    sc_uint < XLEN > zero_ext_zimm(sc_uint < ZIMM_SIZE > zimm) {
-		return (sc_uint < 27 > (0), zimm);
+    ac_int < XLEN, false > zero_ext_zimm(ac_int < ZIMM_SIZE, false > zimm) {
+        ac_int < XLEN, false > zimm_ext = 0;
+        zimm_ext.set_slc(0, zimm);
+        return zimm_ext;
     }
 
     // Return index given a csr address.
-    sc_uint < CSR_IDX_LEN > get_csr_index(sc_uint < CSR_ADDR > csr_addr) {
+    ac_int < CSR_IDX_LEN, false > get_csr_index(ac_int < CSR_ADDR, false > csr_addr) {
         switch (csr_addr) {
         case USTATUS_A:
             return USTATUS_I;
@@ -653,7 +654,7 @@ SC_MODULE(execute) {
     // TODO: respect unwritable fields, see manual for each individual implemented CSR.
     // TODO: for now any bits of every register are fully readable/writeable.
     // TODO: This must be changed in future implementations.
-    void set_csr_value(sc_uint < CSR_IDX_LEN > csr_index, sc_uint < XLEN > rs1, sc_uint < LOG2_CSR_OP_NUM > operation, sc_uint < 2 > rw_permission) {
+    void set_csr_value(ac_int < CSR_IDX_LEN, false > csr_index, ac_int < XLEN, false > rs1, ac_int < LOG2_CSR_OP_NUM, false > operation, ac_int < 2, false > rw_permission) {
         if (rw_permission != 3)
             switch (operation) {
             case CSR_OP_WR:
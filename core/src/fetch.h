@@ -25,9 +25,10 @@
 #include "drim4hls_datatypes.h"
 #include "defines.h"
 #include "globals.h"
+#include "static_prediction.h"
 
 #include <mc_connections.h>
-#include <ac_sysc_macros.h>
+#include <ac_int.h>
 
 SC_MODULE(fetch) {
     public:
@@ -46,9 +47,8 @@ SC_MODULE(fetch) {
     sc_signal < ac_int < LOG2_NUM_CAUSES, false > > CCS_INIT_S1(trap_cause); //sc_out
 
     // *** Internal variables
-    sc_int < PC_LEN > pc; // Init. to -4, then before first insn fetch it will be updated to 0.	 
-    sc_uint < PC_LEN > imem_pc; // Used in fetching from instruction memory
-	sc_uint < PC_LEN > pc_tmp; // Init. to -4, then before first insn fetch it will be updated to 0.	 
+    ac_int < PC_LEN, true > pc; // Pc of the current fetch
+    ac_int < PC_LEN, false > imem_pc; // Used in fetching from instruction memory
     // Custom datatypes used for retrieving and sending data through the channels
     imem_in_t imem_in; // Contains data for fetching from the instruction memory
     fe_out_t fe_out; // Contains data for the decode stage
@@ -58,8 +58,9 @@ SC_MODULE(fetch) {
     bool redirect;
     bool redirect_tmp;
     
-    sc_uint < PC_LEN > redirect_addr;
-	sc_uint < PC_LEN > redirect_addr_tmp;
+    ac_int < PC_LEN, false > redirect_addr;
+	ac_int < PC_LEN, false > redirect_addr_tmp;
+	ac_int < PC_LEN, false > next_pc; // Pc of the next fetch, pc + 4 or statically predicted
 	
     bool freeze;
 	bool freeze_tmp;
@@ -92,10 +93,9 @@ SC_MODULE(fetch) {
             redirect_addr = 0;
 			freeze = false;
 			redirect = false;
-            //  Init. pc to START_ADDRESS - 4 as on first fetch it will be incremented by
-            //  4, thus fetching instruction at address 0
-            pc = -4;
-            pc_tmp = -4;
+            // The first fetch is at address 0
+            pc = 0;
+            next_pc = 0;
             position = 0;
             
             wait();
@@ -116,7 +116,7 @@ SC_MODULE(fetch) {
             if ((redirect && redirect_addr != pc) || freeze) {
                 pc = redirect_addr;
             } else if (!freeze) {
-                pc = (pc + 4);
+                pc = next_pc;
             }
 			
             imem_in.instr_addr = pc;
@@ -126,6 +126,11 @@ SC_MODULE(fetch) {
 			imem_din.Push(imem_in);
 
             imem_out = imem_dout.Pop();
+            #ifdef STATIC_PREDICTION
+            next_pc = static_prediction(pc, imem_out.instr_data);
+            #else
+            next_pc = pc + 4;
+            #endif
 
             imem_de.Push(imem_out);
             dout.Push(fe_out);
@@ -0,0 +1,52 @@
+/*
+	@author VLSI Lab, EE dept., Democritus University of Thrace
+
+	@brief Header file for the static branch prediction
+
+	@note
+		- Backward taken, forward not taken (BTFN). JALs continue at their
+		  target, backward branches are predicted taken, forward branches
+		  and JALRs continue at pc + 4.
+
+		- Fetch follows the guess, decode works it out again for the same
+		  instruction and redirects only when the guess was wrong.
+
+*/
+
+#ifndef __STATIC_PREDICTION__H
+#define __STATIC_PREDICTION__H
+
+#include "defines.h"
+#include "globals.h"
+
+#include <ac_int.h>
+
+// The JAL and branch targets are computed from the instruction alone,
+// JALRs are left to decode.
+inline ac_int < PC_LEN, false > static_prediction(ac_int < PC_LEN, false > pc, ac_int < XLEN, false > insn) {
+    ac_int < OPCODE_SIZE, false > opcode = insn.slc<OPCODE_SIZE>(2);
+    ac_int < PC_LEN, false > offset;
+    if (insn[31] == 0)
+        offset = 0;
+    else
+        offset = 4294967295;
+    
+    if (opcode == OPC_JAL) {
+        offset[0] = 0;
+        offset.set_slc(1, insn.slc<10>(21));
+        offset[11] = insn[20];
+        offset.set_slc(12, insn.slc<8>(12));
+        offset[20] = insn[31];
+        return pc + offset;
+    } else if (opcode == OPC_BEQ && insn[31] == 1) {
+        offset[0] = 0;
+        offset.set_slc(1, insn.slc<4>(8));
+        offset.set_slc(5, insn.slc<6>(25));
+        offset[11] = insn[7];
+        offset[12] = insn[31];
+        return pc + offset;
+    }
+    return pc + 4;
+}
+
+#endif
@@ -39,12 +39,12 @@ class Top: public sc_module {
     Connections::Combinational < dmem_out_t > CCS_INIT_S1(dmem2wb_ch);
     Connections::Combinational < dmem_in_t > CCS_INIT_S1(wb2dmem_ch);
 
-    sc_uint < XLEN > imem[ICACHE_SIZE];
+    ac_int < XLEN, false > imem[ICACHE_SIZE];
 
     imem_out_t imem_dout;
     imem_in_t imem_din;
 
-    sc_uint < XLEN > dmem[DCACHE_SIZE];
+    ac_int < XLEN, false > dmem[DCACHE_SIZE];
 
     dmem_out_t dmem_dout;
     dmem_in_t dmem_din;
@@ -29,7 +29,7 @@
 #include "globals.h"
 
 #include <mc_connections.h>
-#include <ac_sysc_macros.h>
+#include <ac_int.h>
 
 SC_MODULE(writeback) {
     #ifndef __SYNTHESIS__
@@ -39,8 +39,8 @@ SC_MODULE(writeback) {
         // Member declarations.
         //		
         unsigned int aligned_address;
-        sc_uint < XLEN > load_data;
-        sc_uint < XLEN > store_data;
+        ac_int < XLEN, false > load_data;
+        ac_int < XLEN, false > store_data;
         std::string load;
         std::string store;
 
@@ -65,8 +65,8 @@ SC_MODULE(writeback) {
     dmem_out_t dmem_din;
     mem_out_t output;
 
-    sc_uint < DATA_SIZE > mem_dout;
-    sc_uint < XLEN > dmem_data;
+    ac_int < DATA_SIZE, false > mem_dout;
+    ac_int < XLEN, false > dmem_data;
     
     // Constructor
     SC_CTOR(writeback): din("din"), dout("dout"), dmem_in("dmem_in"), dmem_out("dmem_out"), clk("clk"), rst("rst") {
@@ -115,13 +115,13 @@ SC_MODULE(writeback) {
             // Preprocess address
 			
             unsigned int aligned_address = input.alu_res.to_uint();
-            sc_uint< 5 > byte_index = (sc_uint< 5 >)((aligned_address & 0x3) << 3);
-            sc_uint< 5 > halfword_index = (sc_uint< 5 >)((aligned_address & 0x2) << 3);
+            ac_int < 5, false > byte_index = (ac_int < 5, false >)((aligned_address & 0x3) << 3);
+            ac_int < 5, false > halfword_index = (ac_int < 5, false >)((aligned_address & 0x2) << 3);
 
             aligned_address = aligned_address >> 2;
-            sc_uint < BYTE > db = (sc_uint < BYTE >) 0;
-            sc_uint < 2 * BYTE > dh = (sc_uint < 2 * BYTE >) 0;
-            sc_uint < XLEN > dw = (sc_uint < XLEN >) 0;
+            ac_int < BYTE, false > db = (ac_int < BYTE, false >) 0;
+            ac_int < 2 * BYTE, false > dh = (ac_int < 2 * BYTE, false >) 0;
+            ac_int < XLEN, false > dw = (ac_int < XLEN, false >) 0;
 
             dmem_dout.data_addr = aligned_address;
 
@@ -130,7 +130,7 @@ SC_MODULE(writeback) {
             
 
             #ifndef __SYNTHESIS__
-            if (sc_uint < 3 > (input.ld) != NO_LOAD || sc_uint < 2 > (input.st) != NO_STORE) {
+            if (ac_int < 3, false > (input.ld) != NO_LOAD || ac_int < 2, false > (input.st) != NO_STORE) {
                 if (input.mem_datain.to_uint() == 0x11111111 ||
                     input.mem_datain.to_uint() == 0x22222222 ||
                     input.mem_datain.to_uint() == 0x11223344 ||
@@ -154,7 +154,7 @@ SC_MODULE(writeback) {
                 //freeze = false;
                 switch (input.ld) { // LOAD
                 case LB_LOAD:
-                    db = dmem_data.range(byte_index + BYTE - 1, byte_index);
+                    db = dmem_data.slc<BYTE>(byte_index);
                     mem_dout = ext_sign_byte(db);
 
                     #ifndef __SYNTHESIS__
@@ -164,7 +164,7 @@ SC_MODULE(writeback) {
 
                     break;
                 case LH_LOAD:
-                    dh = dmem_data.range(halfword_index + 2 * BYTE - 1, halfword_index);
+                    dh = dmem_data.slc<2 * BYTE>(halfword_index);
                     mem_dout = ext_sign_halfword(dh);
 
                     #ifndef __SYNTHESIS__
@@ -184,7 +184,7 @@ SC_MODULE(writeback) {
 
                     break;
                 case LBU_LOAD:
-                    db = dmem_data.range(byte_index + BYTE - 1, byte_index);
+                    db = dmem_data.slc<BYTE>(byte_index);
                     mem_dout = ext_unsign_byte(db);
 
                     #ifndef __SYNTHESIS__
@@ -194,10 +194,10 @@ SC_MODULE(writeback) {
 
                     break;
                 case LHU_LOAD:
-                    //dh = dmem_data.range(halfword_index + 2 * BYTE - 1, halfword_index);
+                    //dh = dmem_data.slc<2 * BYTE>(halfword_index);
                     //dh = dmem_data.slc< 2 * BYTE >(halfword_index);
                     //dh.set_slc(0, dmem_data.slc< 2 * BYTE >(halfword_index));
-                    dh = dmem_data.range(halfword_index + 2 * BYTE - 1, halfword_index);
+                    dh = dmem_data.slc<2 * BYTE>(halfword_index);
                     mem_dout = ext_unsign_halfword(dh);
 
                     #ifndef __SYNTHESIS__
@@ -222,8 +222,8 @@ SC_MODULE(writeback) {
                 switch (input.st) { // STORE
                 case SB_STORE: // store 8 bits of rs2
 					
-					db = input.mem_datain.range(BYTE - 1, 0).to_uint();
-                    dmem_data.range(byte_index + BYTE - 1, byte_index) = db;
+					db = input.mem_datain.slc<BYTE>(0).to_uint();
+                    dmem_data.set_slc(byte_index, db);
 
                     #ifndef __SYNTHESIS__
                     writeback_out_t.store_data = db;
@@ -233,8 +233,8 @@ SC_MODULE(writeback) {
 					break;
                 case SH_STORE: // store 16 bits of rs2
 					
-					dh = input.mem_datain.range(2 * BYTE - 1, 0).to_uint();
-                    dmem_data.range(byte_index + BYTE - 1, byte_index) = dh;
+					dh = input.mem_datain.slc<2 * BYTE>(0).to_uint();
+                    dmem_data.set_slc(byte_index, dh);
                     
                     #ifndef __SYNTHESIS__
                     writeback_out_t.store_data = dh;
@@ -296,41 +296,37 @@ SC_MODULE(writeback) {
     /* Support functions */
 
     // Sign extend byte read from memory. For LB
-    sc_uint < XLEN > ext_sign_byte(sc_uint < BYTE > read_data) {
+    ac_int < XLEN, false > ext_sign_byte(ac_int < BYTE, false > read_data) {
+		ac_int < XLEN, false > extended = 0;
+		extended.set_slc(0, read_data);
 		if (read_data[7] == 1) {
-			
-			return (sc_uint < BYTE * 3 > (16777216), read_data);
-
-		}
-		else {
-
-			return (sc_uint < BYTE * 3 > (0), read_data);
+			extended.set_slc(BYTE, (ac_int < BYTE * 3, false >) 16777215);
 		}
+		return extended;
     }
 
     // Zero extend byte read from memory. For LBU
-    sc_uint < XLEN > ext_unsign_byte(sc_uint < BYTE > read_data) {
-
-		return (sc_uint < BYTE * 3 > (0), read_data);       
+    ac_int < XLEN, false > ext_unsign_byte(ac_int < BYTE, false > read_data) {
+		ac_int < XLEN, false > extended = 0;
+		extended.set_slc(0, read_data);
+		return extended;
     }
 
     // Sign extend half-word read from memory. For LH
-    sc_uint < XLEN > ext_sign_halfword(sc_uint < BYTE * 2 > read_data) {
-		        
+    ac_int < XLEN, false > ext_sign_halfword(ac_int < BYTE * 2, false > read_data) {
+		ac_int < XLEN, false > extended = 0;
+		extended.set_slc(0, read_data);
         if (read_data[15] == 1) {
-
-            return (sc_uint < BYTE * 2 > (65535), read_data);
-        }
-        else {
-
-            return (sc_uint < BYTE * 2 > (0), read_data);
+			extended.set_slc(2 * BYTE, (ac_int < BYTE * 2, false >) 65535);
         }
+        return extended;
     }
 
     // Zero extend half-word read from memory. For LHU
-    sc_uint < XLEN > ext_unsign_halfword(sc_uint < BYTE * 2 > read_data) {
-
-		return (sc_uint < BYTE * 2 > (0), read_data);
+    ac_int < XLEN, false > ext_unsign_halfword(ac_int < BYTE * 2, false > read_data) {
+		ac_int < XLEN, false > extended = 0;
+		extended.set_slc(0, read_data);
+		return extended;
     }
 
 };
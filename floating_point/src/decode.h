@@ -25,6 +25,7 @@
 #include "drim4hls_datatypes.h"
 #include "defines.h"
 #include "globals.h"
+#include "../../common/compare.h"
 
 #include <mc_connections.h>
 #include <ac_int.h>
@@ -434,75 +435,14 @@ SC_MODULE(decode) {
             if (insn.slc<5>(2) == OPC_BEQ) { // BEQ,BNE, BLT, BGE, BLTU, BGEU
 				fetch_out.btb_update = true;
 				fetch_out.bta = self_feed.branch_address;
-                switch (insn.slc<3>(12)) {
-                case FUNCT3_BEQ:
-                    if (output.rs1 == output.rs2) {
-						branch = true; // BEQ taken.
-						fetch_out.branch_taken = true;
-						fetch_out.address = self_feed.branch_address;
-						#ifndef __SYNTHESIS__
-						debug_dout_t.branch_taken = true;
-						#endif
-					}
-
-                    break;
-                case FUNCT3_BNE:
-                    if (output.rs1 != output.rs2) {
-						branch = true; //BNE taken.
-						fetch_out.branch_taken = true;
-                        fetch_out.address = self_feed.branch_address;
-                        #ifndef __SYNTHESIS__
-                        debug_dout_t.branch_taken = true;
-                        #endif
-                    }
-                    break;
-                case FUNCT3_BLT:
-                    if (output.rs1 < output.rs2) {
-						branch = true; // BLT taken
-						fetch_out.branch_taken = true;
-						fetch_out.address = self_feed.branch_address;
-                        #ifndef __SYNTHESIS__
-                        debug_dout_t.branch_taken = true;
-                        #endif
-                    }
-                    break;
-                case FUNCT3_BGE:
-                    if (output.rs1 >= output.rs2) {
-						branch = true; // BGE taken.
-						fetch_out.branch_taken = true;
-						fetch_out.address = self_feed.branch_address;
-                        #ifndef __SYNTHESIS__
-                        debug_dout_t.branch_taken = true;
-                        #endif
-                    }
-                    break;
-                case FUNCT3_BLTU:
-                    if (output.rs1 < output.rs2) {
-						branch = true; // BLTU taken.
-						fetch_out.branch_taken = true;
-						fetch_out.address = self_feed.branch_address;
-                        #ifndef __SYNTHESIS__
-                        debug_dout_t.branch_taken = true;
-                        #endif
-                    }
-                    break;
-                case FUNCT3_BGEU:
-                    if (output.rs1 >= output.rs2) {
-						branch = true; // BGEU taken.
-						fetch_out.branch_taken = true;
-						fetch_out.address = self_feed.branch_address;
-                        #ifndef __SYNTHESIS__
-                        debug_dout_t.branch_taken = true;
-                        #endif
-                    }
-                    break;
-                default:
-                    branch = false; // default to not taken.
-                    #ifndef __SYNTHESIS__
-                    debug_dout_t.branch_taken = false;
-                    #endif
-                    break;
+                branch = branch_taken(compare(output.rs1, output.rs2), insn.slc<3>(12));
+                if (branch) {
+					fetch_out.branch_taken = true;
+					fetch_out.address = self_feed.branch_address;
                 }
+                #ifndef __SYNTHESIS__
+                debug_dout_t.branch_taken = branch;
+                #endif
             }
             // -- All data for feedback path to fetch is ready now. Do put(): in this version it saved data in self_feed.
             // *** END of feedback to fetch data computation and put() section.
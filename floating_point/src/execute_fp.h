@@ -30,6 +30,7 @@
 #include "drim4hls_datatypes.h"
 #include "defines.h"
 #include "globals.h"
+#include "../../common/compare.h"
 
 #include <mc_connections.h>
 #include <ac_int.h>
@@ -307,14 +308,14 @@ SC_MODULE(execute_fp) {
 
                 break;
             case ALUOP_FLT: // FLT
-				if (fp_rs1  < fp_rs2)
+				if (float_less(input.rs1, tmp_rs2, false))
                     output.alu_res = 1;
                 else
                     output.alu_res = 0;
 
                 break;
             case ALUOP_FLE: // FLE
-				if (fp_rs1  <= fp_rs2)
+				if (float_less(input.rs1, tmp_rs2, true))
                     output.alu_res = 1;
                 else
                     output.alu_res = 0;
@@ -480,6 +481,25 @@ SC_MODULE(execute_fp) {
 
     /* Support functions */
 
+    // FLT and FLE. The magnitudes, sign bit cleared, are compared on the same
+    // unit as the branches. Two values of the same sign are ordered like their
+    // magnitudes, reversed when negative.
+    bool float_less(ac_int < XLEN, false > rs1, ac_int < XLEN, false > rs2, bool or_equal) {
+        ac_int < XLEN, false > mag1 = rs1;
+        ac_int < XLEN, false > mag2 = rs2;
+        mag1[XLEN - 1] = 0;
+        mag2[XLEN - 1] = 0;
+        compare_t cmp = compare(mag1, mag2);
+
+        bool less;
+        if (rs1[XLEN - 1] == 0) {
+            less = cmp.ltu || (or_equal && cmp.eq);
+        } else {
+            less = !cmp.ltu && (or_equal || !cmp.eq);
+        }
+        return (rs1[XLEN - 1] == 1 && rs2[XLEN - 1] == 0) || (rs1[XLEN - 1] == rs2[XLEN - 1] && less);
+    }
+
     // Sign extend immS.
     ac_int < XLEN, false > sign_extend_imm_s(ac_int < 12, false > imm) {
         ac_int <XLEN, false> imm_ext = 0;
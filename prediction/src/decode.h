@@ -8,8 +8,18 @@
 
 		- Use of HLSLibs connections for communication with the rest of the processor.
 
-		- Stall mechanism manages data dependencies, dynamic load/write memory stalls
-		  and change of program direction.
+		- Stall mechanism manages data dependencies and dynamic load/write memory stalls.
+
+		- Branches and jumps are resolved in execute. Instructions fetched on a
+		  mispredicted path carry an older epoch tag and are squashed into bubbles.
+
+		- The register file, the scoreboard and the hazard checks are in
+		  regread.h. When DECODE_SPLIT is defined they move to the issue stage
+		  and decode only builds the control word, see issue.h.
+
+		- When DECODE_MEMO is defined, the simulation keeps the control word
+		  of every decoded instruction by pc and skips the opcode switch when
+		  the same word is decoded again. Not synthesized.
 
 
 */
@@ -25,19 +35,26 @@
 #include "drim4hls_datatypes.h"
 #include "defines.h"
 #include "globals.h"
+#include "regread.h"
 
 #include <mc_connections.h>
 
+#ifndef __SYNTHESIS__
+    #include <unordered_map>
+#endif
+
 SC_MODULE(decode) {
     public:
     // Clock and reset signals
     sc_in < bool > CCS_INIT_S1(clk);
     sc_in < bool > CCS_INIT_S1(rst);
     // FlexChannel initiators
+    Connections::In < fe_out_t > CCS_INIT_S1(fetch_din);
+    #ifdef DECODE_SPLIT
+    Connections::Out < de_iss_t > CCS_INIT_S1(dout);
+    #else
     Connections::Out < de_out_t > CCS_INIT_S1(dout);
-    Connections::Out < fe_in_t > CCS_INIT_S1(fetch_dout);
     Connections::In < mem_out_t > CCS_INIT_S1(feed_from_wb);
-    Connections::In < fe_out_t > CCS_INIT_S1(fetch_din);
     Connections::In < reg_forward_t > CCS_INIT_S1(fwd_exe);
     
     // End of simulation signal.
@@ -49,81 +66,71 @@ SC_MODULE(decode) {
     sc_out < long int > CCS_INIT_S1(b_icount);
     sc_out < long int > CCS_INIT_S1(m_icount);
     sc_out < long int > CCS_INIT_S1(o_icount);
+    #endif
     
-    bool jump;
-    bool branch;
     // Trap signals. TODO: not used. Left for future implementations.
     sc_signal < bool > CCS_INIT_S1(trap); //sc_out
     sc_signal < ac_int < LOG2_NUM_CAUSES, false > > CCS_INIT_S1(trap_cause); //sc_out
 
+    // Stalls on a hazard or, when DECODE_SPLIT is defined, while the issue
+    // stage has not taken the previous instruction
     bool freeze;
     // Flushes current instruction in order to sychronize processor with a
     // change of direction in the execution
     bool flush;
-	
-    bool forward_success_rs1;
-    bool forward_success_rs2;
-
-    bool load_instruction;
-    sc_int < PC_LEN > load_pc;
-
-    sc_uint < INSN_LEN > insn; // Contains full instruction fetched from IMEM. Used in decoding.
-    sc_int < PC_LEN > pc; // Contains PC for the current instruction that is decoded   
-    // NB. x0 is included in this regfile so it is not a real hardcoded 0
-    // constant. The writeback section of fedec has a guard fro writes on
-    // x0. For double protection, some instructions that want to write into
-    // x0 will have their regwrite signal forced to false.
-    sc_uint < XLEN > regfile[REG_NUM];
-    // Keeps track of in-flight instructions that are going to overwrite a
-    // register. Implements a primitive stall mechanism for RAW hazards.
-    sc_uint < XLEN + 1 > sentinel[REG_NUM];
-
-    sc_uint < TAG_WIDTH > tag;
+
+    #ifndef DECODE_SPLIT
+    regread_t rr; // Register file, scoreboard and hazard checks
+    #ifndef __SYNTHESIS__
+    long int fused_pairs;
+    #endif
+    #endif
+
+    ac_int < INSN_LEN, false > insn; // Contains full instruction fetched from IMEM. Used in decoding.
+    ac_int < PC_LEN, true > pc; // Contains PC for the current instruction that is decoded   
+    // Instructions fetched with an older epoch than the one of the register
+    // read follow a mispredicted branch and are squashed.
+    bool squash;
+    // Macro-op fusion of the instruction from fetch, see globals.h
+    ac_int < FUSE_WIDTH, false > fuse;
     // Stalls processor and sends a nop operation to the execute stage
-    sc_uint < OPCODE_SIZE > opcode;
+    ac_int < OPCODE_SIZE, false > opcode;
 
     int position;
     // Member variables (DECODE)
-    de_in_t self_feed; // Contains branch and jump data		 
-    mem_out_t feedinput; // Contains data from writeback stage
-    mem_out_t feedinput_tmp; // Contains data from writeback stage
     de_out_t output; // Contains data for the execute stage
+    #ifdef DECODE_SPLIT
+    de_iss_t iss_out; // Contains data for the issue stage
+    #endif
     fe_out_t input; // Contains data from the fetch stage
-    fe_in_t fetch_out; // Contains data for the fetch stage about processor stalls
-
-    reg_forward_t fwd;
-    reg_forward_t temp_fwd;
 
     fe_out_t fetch_in; // Buffer for the data coming from the fetch stage
 
     unsigned int imem_data; // Contains instruction data
    
 	bool freeze_tmp;
-	sc_uint< 32 > addr_tmp;
-	sc_uint< 5 > zero_reg_addr;
+	ac_int < 32, false > addr_tmp;
+	ac_int < 5, false > zero_reg_addr;
      
     bool flush_next;
     bool new_instr;
     int position_fwd;
     int position_wb;
-    
-    sc_uint < DCACHE_INDEX_WIDTH > last_ldst_index;
-    sc_uint < DCACHE_INDEX_WIDTH > last_ldst_index_temp;
-    bool last_ldst_valid;
      
     SC_CTOR(decode): clk("clk"),
     rst("rst"),
-    dout("dout"),
-    feed_from_wb("feed_from_wb"),
     fetch_din("fetch_din"),
-    fetch_dout("fetch_dout"),
+    #ifndef DECODE_SPLIT
+    feed_from_wb("feed_from_wb"),
     program_end("program_end"),
     fwd_exe("fwd_exe"),
     icount("icount"),
     j_icount("j_icount"),
     b_icount("b_icount"),
     m_icount("m_icount"),
-    o_icount("o_icount") {
+    o_icount("o_icount"),
+    #endif
+    dout("dout") {
         
         SC_THREAD(decode_th);
         sensitive << clk.pos();
@@ -145,30 +152,49 @@ SC_MODULE(decode) {
         bool rs1_forward;
         bool rs2_forward;
         bool branch_taken;
-        sc_uint < XLEN > rs1;
-        sc_uint < XLEN > rs2;
+        ac_int < XLEN, false > rs1;
+        ac_int < XLEN, false > rs2;
         std::string dest_reg;
         int pc;
         int aligned_pc;
-        sc_uint < XLEN - 12 > imm_u;
-        sc_uint < TAG_WIDTH > tag;
+        ac_int < XLEN - 12, false > imm_u;
+        ac_int < TAG_WIDTH, false > tag;
 
     }
     debug_dout_t;
     #endif
 
+    #if defined(DECODE_MEMO) && !defined(__SYNTHESIS__)
+    // Decoded control word of the instruction at a pc
+    struct decode_memo_t {
+        unsigned int instr_data; // Fetched word the entry was decoded from
+        unsigned int fused_instr;
+        unsigned int fuse;
+        ac_int < REG_ADDR, false > rs1_addr;
+        ac_int < REG_ADDR, false > rs2_addr;
+        de_out_t control; // alu_op, alu_src, regwrite, memtoreg, ld, st, dest_reg, imm_u
+        bool trap;
+        ac_int < LOG2_NUM_CAUSES, false > trap_cause;
+        debug_dout debug;
+    };
+    std::unordered_map < unsigned int, decode_memo_t > memo;
+    decode_memo_t * memo_entry;
+    decode_memo_t * memo_last; // Stored in the previous cycle, trap not read yet
+    long int memo_hits;
+    long int memo_misses;
+    #endif
+
     void decode_th(void) {
         DECODE_RST: {
             dout.Reset();
             fetch_din.Reset();
+            #ifndef DECODE_SPLIT
             feed_from_wb.Reset();
-            fetch_dout.Reset();
             fwd_exe.Reset();
-			//fetch_dout.write(fetch_out);
-            // Init. sentinel flags to zero.
-            for (int i = 0; i < REG_NUM; i++) {
-                sentinel[i] = SENTINEL_INIT;
-            }
+            rr.reset();
+            #ifndef __SYNTHESIS__
+            fused_pairs = 0;
+            #endif
 
             // Program has not completed
             program_end.write(false);
@@ -177,6 +203,14 @@ SC_MODULE(decode) {
             b_icount.write(0); // branch
             m_icount.write(0); // load, store
             o_icount.write(0); // other
+            #endif
+            #if defined(DECODE_MEMO) && !defined(__SYNTHESIS__)
+            memo.clear();
+            memo_entry = NULL;
+            memo_last = NULL;
+            memo_hits = 0;
+            memo_misses = 0;
+            #endif
             
             addr_tmp = 0;
             zero_reg_addr = 0;
@@ -186,23 +220,14 @@ SC_MODULE(decode) {
 	        flush_next = false;
             freeze_tmp = false;
 
-            forward_success_rs1 = false;
-            forward_success_rs2 = false;
             position = 0;
             insn = 0;
-            branch = false;
-            jump = false;
+            squash = false;
+            fuse = FUSE_NONE;
             pc = -4;
-            load_instruction = false;
-            load_pc = -4;
             new_instr = false;
             position_fwd = 0;
             position_wb = 0;
-            fetch_out.address = 0;
-
-			last_ldst_valid = false;
-			last_ldst_index = 0;
-			last_ldst_index_temp = 0;
 
             wait();
         }
@@ -220,38 +245,36 @@ SC_MODULE(decode) {
 			}
 			
     
-            if (position_fwd == 1) {
-				fwd = fwd_exe.Pop();
+			#ifndef DECODE_SPLIT
+			if (position_fwd == 1) {
+				rr.forward(fwd_exe.Pop());
 			}else {
 				position_fwd = 1;
 			}
+			// Wrong-path instruction, fetched before execute redirected the fetch
+			squash = (fetch_in.tag != rr.epoch);
 			
 			if (position_wb == 2) {
-				feedinput = feed_from_wb.Pop();
-				
-				if (feedinput.pc == load_pc && load_instruction) {
-                    load_instruction = false;
-                }
+				rr.writeback(feed_from_wb.Pop());
 			}else {
 				position_wb++;
 			}
-
-            if (feedinput.regwrite == 1 && feedinput.regfile_address != 0) { // Actual writeback.
-                    regfile[feedinput.regfile_address] = feedinput.regfile_data; // Overwrite register.
-
-				if ((feedinput.pc == sentinel[feedinput.regfile_address].range(32,1)) && (sentinel[feedinput.regfile_address][0] == 1)) {
-					sentinel[feedinput.regfile_address][0] = 0;
-				}
-
-            }
+			rr.release();
+			#endif
 
             flush_next = false;
             new_instr = false;
             
             insn = imem_data;
+
+            // *** Macro-op fusion. LUI, AUIPC and SLLI pairs are decoded as
+            // their second instruction, compare-and-branch pairs as the compare.
+            fuse = fetch_in.fuse;
+            ac_int < INSN_LEN, false > fuse_first = insn;
+            if (fuse != FUSE_NONE && fuse != FUSE_CMP_BEQZ && fuse != FUSE_CMP_BNEZ) {
+                insn = fetch_in.fused_instr;
+            }
 			    
-			forward_success_rs1 = false;
-            forward_success_rs2 = false;
                 
             new_instr = true;
 
@@ -259,208 +282,139 @@ SC_MODULE(decode) {
             debug_dout_t.pc = pc;
             #endif
 
-            output.pc = pc;
-            fetch_out.pc = pc;
+            // A fused pair carries the pc of its second instruction, so branches,
+            // jumps and links resolve in execute as for a single instruction
+            output.pc = (fuse != FUSE_NONE) ? (ac_int < PC_LEN, false >)(pc + 4) : (ac_int < PC_LEN, false >) pc;
+            output.fuse = fuse;
+            output.predecode = fetch_in.predecode;
+            output.next_pc = fetch_in.next_pc;
+            output.ras_top = fetch_in.ras_top;
+            output.ras_tos = fetch_in.ras_tos;
             // Increment some instruction counters
-            //opcode = sc_uint < OPCODE_SIZE > (sc_bv < OPCODE_SIZE > (insn.range(6, 2)));
-			opcode = insn.range(6, 2);
+            //opcode = ac_int < OPCODE_SIZE, false > (sc_bv < OPCODE_SIZE > (insn.slc<5>(2)));
+			opcode = insn.slc<5>(2);
 
-            if (opcode == OPC_LW || opcode == OPC_SW) {
+            #ifndef DECODE_SPLIT
+            if (squash) {
+                // Not counted
+            }
+            else if (fetch_in.predecode.ldst) {
                 // Increment memory instruction counter
 				m_icount.write(m_icount.read() + 1);
 			}
-            else if (opcode == OPC_JAL || opcode == OPC_JALR) {
+            else if (fetch_in.predecode.jal || fetch_in.predecode.jalr) {
 				// Increment jump instruction counter
                 j_icount.write(j_icount.read() + 1);
-			} else if (opcode == OPC_BEQ) {
+			} else if (fetch_in.predecode.branch) {
 				// Increment branch instruction counter
 				b_icount.write(b_icount.read() + 1);
             } else {
 				// Increment other instruction counter
                 o_icount.write(o_icount.read() + 1);
 			}
-            icount.write(icount.read() + 1);
+            if (!squash) {
+                icount.write(icount.read() + ((fuse != FUSE_NONE) ? 2 : 1));
+            }
+            if (!squash && fuse != FUSE_NONE) {
+                // The first instruction of a fused pair
+                o_icount.write(o_icount.read() + 1);
+                #ifndef __SYNTHESIS__
+                fused_pairs++;
+                #endif
+            }
             
             freeze_tmp = false;
 
-           if (insn == 0x0000006f) {
+           if (insn == 0x0000006f && !squash) {
                 // jump to yourself (end of program).
                 program_end.write(true);
             }
+            #endif
 
-            sc_uint < REG_ADDR > rs1_addr = insn.range(19, 15);
-            sc_uint < REG_ADDR > rs2_addr = insn.range(24, 20);
-			
-			
-			sc_uint< 32 > rs1_sent_pc = sentinel[rs1_addr].range(32, 1);
-			sc_uint < 1 > rs1_sent_valid = sentinel[rs1_addr].range(0, 0);
-            
-            if (!fwd.ldst && fwd.pc == rs1_sent_pc && rs1_sent_valid == 1) {
-                forward_success_rs1 = true;
-                output.rs1 = fwd.regfile_data;
-                #ifndef __SYNTHESIS__
-                debug_dout_t.rs1 = fwd.regfile_data;
-                debug_dout_t.rs1_forward = forward_success_rs1;
-                #endif
-            } else if (!forward_success_rs1) {
-        
-                output.rs1 = regfile[rs1_addr];
-                #ifndef __SYNTHESIS__
-                debug_dout_t.rs1 = regfile[rs1_addr];
-                debug_dout_t.rs1_forward = forward_success_rs1;
-                #endif
-     
+            // The constant computed by LUI or AUIPC replaces rs1. SLLI+ADD
+            // reads the source of the shift and the other addend.
+            ac_int < XLEN, false > fuse_rs1 = 0;
+            fuse_rs1.set_slc(12, fuse_first.slc<20>(12));
+            if (fuse == FUSE_AUIPC_JALR || fuse == FUSE_AUIPC_LOAD) {
+                fuse_rs1 = fuse_rs1 + pc;
             }
 
-            sc_uint < 32 > rs2_sent_pc = sentinel[rs2_addr].range(32, 1);
-			sc_uint < 1 > rs2_sent_valid = sentinel[rs2_addr].range(0, 0);
-			
-            if (!fwd.ldst && fwd.pc == rs2_sent_pc && rs2_sent_valid == 1) {
-                forward_success_rs2 = true;
-                output.rs2 = fwd.regfile_data;
-				#ifndef __SYNTHESIS__
-                debug_dout_t.rs2 = fwd.regfile_data;
-                debug_dout_t.rs2_forward = forward_success_rs2;
-                #endif
-
-            } else if (!forward_success_rs2) {
-                
-                output.rs2 = regfile[rs2_addr];
-                #ifndef __SYNTHESIS__
-                debug_dout_t.rs2 = regfile[rs2_addr];
-                debug_dout_t.rs2_forward = forward_success_rs2;
-                #endif
-
-            
+            // An ALU operation into x0 or a move of a register onto itself
+            // (ADDI rd, rd, 0) has no effect. It is issued as a bubble and
+            // does not wait for its sources.
+            bool nop = false;
+            if (fuse == FUSE_NONE && (opcode == OPC_ADDI || opcode == OPC_ADD || opcode == OPC_LUI || opcode == OPC_AUIPC)) {
+                nop = (insn.slc<5>(7) == 0) ||
+                    (opcode == OPC_ADDI && insn.slc<3>(12) == FUNCT3_ADDI && insn.slc<12>(20) == 0 && insn.slc<5>(7) == insn.slc<5>(15));
             }
-
-            // *** Feedback to fetch data computation and put() section.
-            // -- Address sign extensions.
-            sc_uint < 21 > immjal_tmp = ((sc_uint<1>)insn.range(31, 31), (sc_uint<8>)insn.range(19, 12), (sc_uint<1>)insn.range(20, 20), (sc_uint<10>)insn.range(30, 21), (sc_uint<1>)(0));
-            sc_uint < 13 > immbranch_tmp = ((sc_uint<1>)insn.range(31, 31), (sc_uint<1>)insn.range(7, 7), (sc_uint<6>)insn.range(30, 25), (sc_uint<4>)insn.range(11, 8), (sc_uint<1>)(0));
-
-            self_feed.branch_address = sign_extend_branch(immbranch_tmp + pc);
-            // -- Jump.
-            fetch_out.branch_taken = false;
-            fetch_out.btb_update = false;
-            fetch_out.ras_update = false;
-            fetch_out.address = pc + 4;
-            jump = false;
-            
-            if (insn.range(6, 2) == OPC_JAL) {
-                self_feed.jump_address = sign_extend_jump(immjal_tmp + pc);
-                jump = true;
-                fetch_out.ras_update = true;
-                fetch_out.bta = self_feed.jump_address;
-                fetch_out.address = self_feed.jump_address;
-            } else if (insn.range(6, 2) == OPC_JALR) {
-                sc_uint < PC_LEN > extended;
-                if (insn[31] == 0)
-                    extended = 0;
-                else
-                    extended = 4294967295;
-
-                extended.range(11, 0) = insn.range(31, 20);
-                self_feed.jump_address = extended + output.rs1;
-                self_feed.jump_address[0] = 0;
-                
-                jump = true;
-
-                fetch_out.bta = self_feed.jump_address;
-                fetch_out.address = self_feed.jump_address;
+            // ADDI rd, rs1, 0 onto another register, issue may eliminate it.
+            // Loads share the ALU operation and operands of ADDI, so the
+            // move is told from the opcode and not from the control word.
+            output.move = (fuse == FUSE_NONE && opcode == OPC_ADDI && insn.slc<3>(12) == FUNCT3_ADDI && insn.slc<12>(20) == 0 && !nop);
+
+            ac_int < REG_ADDR, false > rs1_addr;
+            ac_int < REG_ADDR, false > rs2_addr;
+            #if defined(DECODE_MEMO) && !defined(__SYNTHESIS__)
+            memo_entry = memo_lookup();
+            if (memo_entry) {
+                rs1_addr = memo_entry->rs1_addr;
+                rs2_addr = memo_entry->rs2_addr;
+            } else
+            #endif
+            {
+                rs1_addr = insn.slc<5>(15);
+                rs2_addr = insn.slc<5>(20);
+                if (fuse == FUSE_LUI_ADDI || fuse == FUSE_AUIPC_JALR || fuse == FUSE_AUIPC_LOAD) {
+                    rs1_addr = 0;
+                } else if (fuse == FUSE_SLLI_ADD) {
+                    rs2_addr = (insn.slc<5>(15) == fuse_first.slc<5>(7)) ? insn.slc<5>(20) : insn.slc<5>(15);
+                    rs1_addr = fuse_first.slc<5>(15);
+                }
+                // Fields that are not register sources read x0, which is
+                // never pending, so the immediate bits of I-, U- and J-type
+                // instructions do not make up a dependence.
+                if (opcode == OPC_LUI || opcode == OPC_AUIPC || opcode == OPC_JAL || (opcode == OPC_SYSTEM && insn[14] == 1) || nop) {
+                    rs1_addr = 0;
+                }
+                if ((opcode != OPC_ADD && opcode != OPC_SB && opcode != OPC_BEQ) || nop) {
+                    rs2_addr = 0;
+                }
             }
 
-            // -- Branch circuitry.
-            branch = false;
-            if (insn.range(6, 2) == OPC_BEQ) { // BEQ,BNE, BLT, BGE, BLTU, BGEU
-				fetch_out.btb_update = true;
-				fetch_out.bta = self_feed.branch_address;
-                switch (insn.range(14, 12)) {
-                case FUNCT3_BEQ:
-                    if (output.rs1 == output.rs2) {
-						branch = true; // BEQ taken.
-						fetch_out.branch_taken = true;
-						fetch_out.address = self_feed.branch_address;
-						#ifndef __SYNTHESIS__
-						debug_dout_t.branch_taken = true;
-						#endif
-					}
+            #ifdef DECODE_SPLIT
+            // The operands are read by the issue stage
+            iss_out.rs1_addr = rs1_addr;
+            iss_out.rs2_addr = rs2_addr;
+            #else
+            rr.read(rs1_addr, rs2_addr, output);
+            #endif
 
-                    break;
-                case FUNCT3_BNE:
-                    if (output.rs1 != output.rs2) {
-						branch = true; //BNE taken.
-						fetch_out.branch_taken = true;
-                        fetch_out.address = self_feed.branch_address;
-                        #ifndef __SYNTHESIS__
-                        debug_dout_t.branch_taken = true;
-                        #endif
-                    }
-                    break;
-                case FUNCT3_BLT:
-                    if (output.rs1 < output.rs2) {
-						branch = true; // BLT taken
-						fetch_out.branch_taken = true;
-						fetch_out.address = self_feed.branch_address;
-                        #ifndef __SYNTHESIS__
-                        debug_dout_t.branch_taken = true;
-                        #endif
-                    }
-                    break;
-                case FUNCT3_BGE:
-                    if (output.rs1 >= output.rs2) {
-						branch = true; // BGE taken.
-						fetch_out.branch_taken = true;
-						fetch_out.address = self_feed.branch_address;
-                        #ifndef __SYNTHESIS__
-                        debug_dout_t.branch_taken = true;
-                        #endif
-                    }
-                    break;
-                case FUNCT3_BLTU:
-                    if (output.rs1 < output.rs2) {
-						branch = true; // BLTU taken.
-						fetch_out.branch_taken = true;
-						fetch_out.address = self_feed.branch_address;
-                        #ifndef __SYNTHESIS__
-                        debug_dout_t.branch_taken = true;
-                        #endif
-                    }
-                    break;
-                case FUNCT3_BGEU:
-                    if (output.rs1 >= output.rs2) {
-						branch = true; // BGEU taken.
-						fetch_out.branch_taken = true;
-						fetch_out.address = self_feed.branch_address;
-                        #ifndef __SYNTHESIS__
-                        debug_dout_t.branch_taken = true;
-                        #endif
-                    }
-                    break;
-                default:
-                    branch = false; // default to not taken.
-                    #ifndef __SYNTHESIS__
-                    debug_dout_t.branch_taken = false;
-                    #endif
-                    break;
-                }
+            if (fuse == FUSE_LUI_ADDI || fuse == FUSE_AUIPC_JALR || fuse == FUSE_AUIPC_LOAD) {
+                output.rs1 = fuse_rs1;
             }
-            // -- All data for feedback path to fetch is ready now. Do put(): in this version it saved data in self_feed.
-            // *** END of feedback to fetch data computation and put() section.
+            #ifndef __SYNTHESIS__
+            debug_dout_t.rs1 = output.rs1;
+            debug_dout_t.rs2 = output.rs2;
+            #endif
 
+            #if defined(DECODE_MEMO) && !defined(__SYNTHESIS__)
+            if (memo_entry) {
+                memo_restore(*memo_entry);
+            } else {
+            #endif
             // *** Propagations: rd, immediates sign extensions.
-            output.dest_reg = insn.range(11 , 7);
+            output.dest_reg = insn.slc<5>(7);
             // RD field of insn.
-            output.imm_u = insn.range(31, 12); // This field is then used in the execute stage not only as immU field but to obtain several subfields used by non U-type instructions.
+            output.imm_u = insn.slc<20>(12); // This field is then used in the execute stage not only as immU field but to obtain several subfields used by non U-type instructions.
 
             #ifndef __SYNTHESIS__
-            debug_dout_t.dest_reg = std::to_string(insn.range(11 , 7).to_int());
-            debug_dout_t.imm_u = insn.range(31, 12);
+            debug_dout_t.dest_reg = std::to_string(insn.slc<5>(7).to_int());
+            debug_dout_t.imm_u = insn.slc<20>(12);
             #endif
             // *** END of RD propagation and immediates sign extensions.
 
             // *** Control word generation.
-            switch (insn.range(6, 2)) { // Opcode's 2 LSBs have been trimmed to save area.
+            switch (insn.slc<5>(2)) { // Opcode's 2 LSBs have been trimmed to save area.
 
             case OPC_LUI:
                 output.alu_op = ALUOP_LUI;
@@ -563,7 +517,7 @@ SC_MODULE(decode) {
                 break;
 
             case OPC_LW:
-                switch (insn.range(14, 12)) {
+                switch (insn.slc<3>(12)) {
                 case FUNCT3_LB:
                     output.ld = LB_LOAD;
 
@@ -626,7 +580,7 @@ SC_MODULE(decode) {
                 break;
 
             case OPC_SW:
-                switch (insn.range(14, 12)) {
+                switch (insn.slc<3>(12)) {
                 case FUNCT3_SB:
                     output.st = SB_STORE;
                     #ifndef __SYNTHESIS__
@@ -672,7 +626,7 @@ SC_MODULE(decode) {
 
             case OPC_ADDI: // OP-IMM instructions (arithmetic and logical operations on immediates): ADDI, SLTI, SLTIU, XORI, ORI, ANDI, SLLI, SRLI, SRAI
 
-                if (insn.range(31 ,25) == FUNCT7_SRAI && insn.range(14, 12) == FUNCT3_SRAI) {
+                if (insn.slc<7>(25) == FUNCT7_SRAI && insn.slc<3>(12) == FUNCT3_SRAI) {
                     output.alu_op = ALUOP_SRAI;
                     output.alu_src = ALUSRC_IMM_U;
 
@@ -680,7 +634,7 @@ SC_MODULE(decode) {
                     debug_dout_t.alu_op = "ALUOP_SRAI";
                     debug_dout_t.alu_src = "ALUSRC_IMM_U";
                     #endif
-                } else if (insn.range(31 ,25) == FUNCT7_SLLI && insn.range(14, 12) == FUNCT3_SLLI) {
+                } else if (insn.slc<7>(25) == FUNCT7_SLLI && insn.slc<3>(12) == FUNCT3_SLLI) {
                     output.alu_op = ALUOP_SLLI;
                     output.alu_src = ALUSRC_IMM_U;
 
@@ -688,7 +642,7 @@ SC_MODULE(decode) {
                     debug_dout_t.alu_op = "ALUOP_SLLI";
                     debug_dout_t.alu_src = "ALUSRC_IMM_U";
                     #endif
-                } else if (insn.range(31 ,25) == FUNCT7_SRLI && insn.range(14, 12) == FUNCT3_SRLI) {
+                } else if (insn.slc<7>(25) == FUNCT7_SRLI && insn.slc<3>(12) == FUNCT3_SRLI) {
                     output.alu_op = ALUOP_SRLI;
                     output.alu_src = ALUSRC_IMM_U;
 
@@ -702,7 +656,7 @@ SC_MODULE(decode) {
                     #ifndef __SYNTHESIS__
                     debug_dout_t.alu_src = "ALUSRC_IMM_I";
                     #endif
-                    switch (insn.range(14, 12)) {
+                    switch (insn.slc<3>(12)) {
                     case FUNCT3_ADDI:
                         output.alu_op = ALUOP_ADDI;
 
@@ -787,9 +741,9 @@ SC_MODULE(decode) {
                 debug_dout_t.memtoreg = "REGWRITE NO";
                 #endif
                 // FUNCT7 switch discriminates between classes of R-type instructions.
-                switch (insn.range(31, 25)) {
+                switch (insn.slc<7>(25)) {
                 case FUNCT7_ADD: // ADD, SLL, SLT, SLTU, XOR, SRL, OR, AND
-                    switch (insn.range(14, 12)) {
+                    switch (insn.slc<3>(12)) {
                     case FUNCT3_ADD:
                         output.alu_op = ALUOP_ADD;
 
@@ -857,7 +811,7 @@ SC_MODULE(decode) {
                     }
                     break;
                 case FUNCT7_SUB: // SUB, SRA
-                    switch (insn.range(14, 12)) {
+                    switch (insn.slc<3>(12)) {
                     case FUNCT3_SUB:
                         output.alu_op = ALUOP_SUB;
 
@@ -884,7 +838,7 @@ SC_MODULE(decode) {
                     break;
                     #if defined(MUL32) || defined(MUL64) || defined(DIV) || defined(REM)
                 case FUNCT7_MUL: // MUL, MULH, MULHSU, MULHU, DIV, DIVU, REM, REMU
-                    switch (insn.range(14, 12)) {
+                    switch (insn.slc<3>(12)) {
                     case FUNCT3_MUL:
                         output.alu_op = ALUOP_MUL;
 
@@ -980,32 +934,32 @@ SC_MODULE(decode) {
                 debug_dout_t.memtoreg = "MEMTOREG NO";
                 debug_dout_t.regwrite = "REGWRITE YES";
                 #endif
-                switch (insn.range(14, 12)) {
+                switch (insn.slc<3>(12)) {
                 case FUNCT3_EBREAK: // EBREAK, ECALL
                     output.regwrite = 0;
                     trap = 1;
                     output.alu_op = ALUOP_CSRRWI;
-                    output.imm_u.range(19, 8) = (sc_uint<CSR_ADDR>)MCAUSE_A; // force the CSR address to MCAUSE's
+                    output.imm_u.set_slc(8, (ac_int < CSR_ADDR, false >)MCAUSE_A); // force the CSR address to MCAUSE's
 
                     #ifndef __SYNTHESIS__
                     debug_dout_t.alu_op = "ALUOP_CSRRWI";
-                    debug_dout_t.imm_u.range(10, 8) = (sc_uint<3>)MCAUSE_A;
+                    debug_dout_t.imm_u.set_slc(8, (ac_int < 3, false >)MCAUSE_A);
                     #endif
                     if (insn[20] == FUNCT7_EBREAK) { // Bit 20 discriminates b/n EBREAK and ECALL
                         // EBREAK and ECALL leverage CSRRWI decoding to write into the MCAUSE register
                         // but keep regwrite to "0" to prevent writeback
                         trap_cause = EBREAK_CAUSE; // may be not necessary but is kept for future implementations
-                        output.imm_u.range(7, 3) = (sc_uint<ZIMM_SIZE>)EBREAK_CAUSE; // force the exception cause on the zimm field
+                        output.imm_u.set_slc(3, (ac_int < ZIMM_SIZE, false >)EBREAK_CAUSE); // force the exception cause on the zimm field
 
                         #ifndef __SYNTHESIS__
-                        debug_dout_t.imm_u.range(7, 3) = (sc_uint<ZIMM_SIZE>)EBREAK_CAUSE;
+                        debug_dout_t.imm_u.set_slc(3, (ac_int < ZIMM_SIZE, false >)EBREAK_CAUSE);
                         #endif
                     } else { // FUNCT7_ECALL
                         trap_cause = ECALL_CAUSE; // may be not necessary but is kept for future implementations
-                        output.imm_u.range(7, 3) = (sc_uint<ZIMM_SIZE>)ECALL_CAUSE; // force the exception cause on the zimm field
+                        output.imm_u.set_slc(3, (ac_int < ZIMM_SIZE, false >)ECALL_CAUSE); // force the exception cause on the zimm field
 
                         #ifndef __SYNTHESIS__
-                        debug_dout_t.imm_u.range(7, 3) = (sc_uint<ZIMM_SIZE>)ECALL_CAUSE;
+                        debug_dout_t.imm_u.set_slc(3, (ac_int < ZIMM_SIZE, false >)ECALL_CAUSE);
                         #endif
                     }
                     break;
@@ -1088,7 +1042,7 @@ SC_MODULE(decode) {
                 trap = 1;
                 trap_cause = ILL_INSN_CAUSE;
                 output.alu_op = ALUOP_CSRRWI;
-                output.imm_u.range(19, 8) = (sc_uint<CSR_ADDR>)MCAUSE_A; // force the CSR address to MCAUSE's
+                output.imm_u.set_slc(8, (ac_int < CSR_ADDR, false >)MCAUSE_A); // force the CSR address to MCAUSE's
 
                 #ifndef __SYNTHESIS__
                 debug_dout_t.alu_src = "ALUSRC_RS2";
@@ -1097,95 +1051,58 @@ SC_MODULE(decode) {
                 debug_dout_t.st = "NO_STORE";
                 debug_dout_t.memtoreg = "MEMTOREG NO";
                 debug_dout_t.alu_op = "ALUOP_CSRRWI";
-                debug_dout_t.imm_u.range(18, 8) = (sc_uint<12>)MCAUSE_A;
-                debug_dout_t.imm_u.range(7, 3) = (sc_uint<5>)ILL_INSN_CAUSE;
+                debug_dout_t.imm_u.set_slc(8, (ac_int < 12, false >)MCAUSE_A);
+                debug_dout_t.imm_u.set_slc(3, (ac_int < 5, false >)ILL_INSN_CAUSE);
                 #endif
                 
                 SC_REPORT_ERROR(sc_object::name(), "Unimplemented instruction");
                 break;
             } // --- END of OPCODE switch
-            // *** END of control word generation.
-            sc_uint <1> sen1_test = sentinel[rs1_addr].range(0, 0);
-            sc_uint <1> sen2_test = sentinel[rs2_addr].range(0, 0);    
-            
-            sc_uint <XLEN> curr_temp_rs2 = 0;
-            if (output.alu_src == ALUSRC_RS2) {
-                curr_temp_rs2 = output.rs2;
-
-            } else if (output.alu_src == ALUSRC_IMM_I) {
-                curr_temp_rs2.range(11, 0) = output.imm_u.range(19, 8);
-                if (output.imm_u[19] == 1) {
-					curr_temp_rs2.range(31 ,12) = (sc_uint < 20 >) 1048575;
-				}
-            } else if (output.alu_src == ALUSRC_IMM_S) {
-				curr_temp_rs2.range(4, 0) = output.dest_reg;
-                curr_temp_rs2.range(11 ,5) = output.imm_u.range(19, 13);
-                 if (curr_temp_rs2[11] == 1) {
-					curr_temp_rs2.range(31, 12) = (sc_uint < 20 >) 1048575;
-				}
 
-            } else {
-				curr_temp_rs2.range(11, 0) = (sc_uint < 12 >) 0; 
-				curr_temp_rs2.range(31, 12) = output.imm_u.range(19, 0);
+            if (fuse == FUSE_SLLI_ADD) {
+                output.alu_op = ALUOP_SHADD;
+                output.imm_u = fuse_first.slc<20>(12); // shamt of the SLLI
+                #ifndef __SYNTHESIS__
+                debug_dout_t.alu_op = "ALUOP_SHADD";
+                #endif
             }
-            
-            sc_uint < XLEN > last_ldst_addr = (output.rs1 + curr_temp_rs2);
-            last_ldst_index_temp = last_ldst_addr.range(1 + DCACHE_OFFSET_WIDTH + DCACHE_INDEX_WIDTH, 2 + DCACHE_OFFSET_WIDTH);
-            
-            if ((output.ld != NO_LOAD || output.st != NO_STORE) && (last_ldst_index_temp == last_ldst_index) && last_ldst_valid && !freeze) {
-                load_instruction = true;
-                load_pc = pc;
+            // Results written to x0 are dropped here, so x0 producers take no
+            // scoreboard tag and writeback never sees them
+            if (output.dest_reg == 0) {
+                output.regwrite = 0;
             }
-            
-            freeze = false;
-            if (load_instruction || (sen1_test && !forward_success_rs1) || (sen2_test && !forward_success_rs2)) {
-				freeze = true;
-			}  
-            
-            sc_uint < 1 > out_regwrite = output.regwrite;
-            sc_uint < 33 > sen_input;
-            
-            if (!freeze && output.regwrite[0] == 1 && output.dest_reg != 0) {
-                sentinel[output.dest_reg].range(XLEN, 1) = pc; // Set corresponding sentinel flag.
-                sentinel[output.dest_reg][0] = 1;
-
-                if (output.dest_reg == rs1_addr) {
-                    forward_success_rs1 = true;
-                } else if (output.dest_reg == rs2_addr) {
-                    forward_success_rs2 = true;
-                }
+            // *** END of control word generation.
+            #if defined(DECODE_MEMO) && !defined(__SYNTHESIS__)
+                memo_store(rs1_addr, rs2_addr);
             }
+            #endif
+            #ifdef DECODE_SPLIT
+            iss_out.op = output;
+            iss_out.rs1_const = (fuse == FUSE_LUI_ADDI || fuse == FUSE_AUIPC_JALR || fuse == FUSE_AUIPC_LOAD);
+            iss_out.bubble = (insn == 0 || nop);
+            iss_out.halt = (insn == 0x0000006f);
+            iss_out.tag = fetch_in.tag;
+            // The instruction is kept while the issue stage stalls
+            freeze = !dout.PushNB(iss_out);
+            #else
+            rr.issue(output, squash, insn == 0 || nop);
+            freeze = rr.freeze;
 
-            // *** Transform instruction into nop when freeze is active
-            if (insn == 0 || freeze) {
-                // Bubble.
-                output.regwrite = 0;
-                output.ld = NO_LOAD;
-                output.st = NO_STORE;
-                output.alu_op = ALUOP_NULL;
-                fetch_out.ras_update = false;
-				fetch_out.btb_update = false;
-                #ifndef __SYNTHESIS__
+            #ifndef __SYNTHESIS__
+            if (insn == 0 || nop || freeze || squash) {
                 debug_dout_t.regwrite = "REGWRITE NO";
                 debug_dout_t.ld = "NO_LOAD";
                 debug_dout_t.st = "NO_STORE";
-                #endif
             }
-            
-            if (output.ld != NO_LOAD || output.st != NO_STORE) {
-				last_ldst_index = last_ldst_index_temp;
-				last_ldst_valid = true;
-			}else {
-				last_ldst_valid = false;
-			}
-			
-            if (!freeze) {
-				fetch_dout.Push(fetch_out);
-			}
-			dout.Push(output);
+            #endif
+
+            dout.Push(output);
+            #endif
 
             #ifndef __SYNTHESIS__
-            DPRINT("@" << sc_time_stamp() << "\t" << name() << "\t" << "load_instruction=" << load_instruction << endl);
+            #ifndef DECODE_SPLIT
+            DPRINT("@" << sc_time_stamp() << "\t" << name() << "\t" << "load_instruction=" << rr.load_instruction << endl);
+            #endif
             DPRINT("@" << sc_time_stamp() << "\t" << name() << "\t" << "insn=" << insn << endl);
             DPRINT("@" << sc_time_stamp() << "\t" << name() << "\t" << "freeze= " << freeze << endl);
             DPRINT("@" << sc_time_stamp() << "\t" << name() << "\t" << "flush= " << flush << endl);
@@ -1202,10 +1119,11 @@ SC_MODULE(decode) {
             DPRINT("@" << sc_time_stamp() << "\t" << name() << "\t" << "imm_u= " << debug_dout_t.imm_u << endl);
             DPRINT(endl);
 
+            #ifndef DECODE_SPLIT
             for (int i = 0; i < REG_NUM;) {
                 DPRINT(endl);
                 for (int j = 0; j < 8; j++) {
-                    int r = regfile[i].to_int();
+                    int r = rr.regfile[i].to_int();
                     DPRINT(" " << std::right << std::setfill(' ') << std::setw(2) << i << ": 0x" << std::hex << std::left << std::setfill(' ') << std::setw(10) << r << std::dec);
                     i++;
                     if (i == REG_NUM)
@@ -1217,42 +1135,80 @@ SC_MODULE(decode) {
             }
             DPRINT(endl);
             #endif
+            #endif
            
             wait();
 
         } // *** ENDOF while(true)
     } // *** ENDOF sc_cthread
 
-    // --- Utility functions.
+    #ifndef __SYNTHESIS__
+    void end_of_simulation() {
+        #ifndef DECODE_SPLIT
+        rr.report();
+        #ifdef MACRO_OP_FUSION
+        std::cout << "MACRO-OP FUSION: " << std::dec << fused_pairs << " pairs fused" << std::endl;
+        #endif
+        #endif
+        #ifdef DECODE_MEMO
+        std::cout << "DECODE MEMO: " << std::dec << memo_hits << " hits, " << memo_misses << " misses, "
+            << memo.size() << " instructions" << std::endl;
+        #endif
+    }
+    #endif
 
-    // Sign extend UJ insn.
-    sc_uint < PC_LEN > sign_extend_jump(sc_uint < 21 > imm) {
-        if (imm[20] == 1) {
-			sc_uint < 32 > ext_imm = 4294967295;
-            ext_imm.range(20, 0) = imm;
-            return ext_imm;
+    #if defined(DECODE_MEMO) && !defined(__SYNTHESIS__)
+    decode_memo_t * memo_lookup() {
+        if (memo_last) {
+            // The trap signals written by the last decode are visible now
+            memo_last->trap = trap.read();
+            memo_last->trap_cause = trap_cause.read();
+            memo_last = NULL;
         }
-        else {
-			sc_uint < 32 > ext_imm = imm;
-			return ext_imm;
-		}
+        std::unordered_map < unsigned int, decode_memo_t >::iterator it = memo.find(fetch_in.pc.to_uint());
+        if (it != memo.end() && it->second.instr_data == fetch_in.instr_data.to_uint() && it->second.fuse == fuse.to_uint() &&
+            (fuse == FUSE_NONE || it->second.fused_instr == fetch_in.fused_instr.to_uint())) {
+            memo_hits++;
+            return &it->second;
+        }
+        memo_misses++;
+        return NULL;
     }
 
-    // Sign extend branch insn.
-    sc_uint < PC_LEN > sign_extend_branch(sc_uint < 13 > imm) {
-        
-        if (imm[12] == 1) {
-			sc_uint < 32 > ext_imm = 4294967295;
-            ext_imm.range(12, 0) = imm;
-            return ext_imm;
-        }
-        else {
-			sc_uint < 32 > ext_imm = imm;
-			return ext_imm;
-		}
+    void memo_store(ac_int < REG_ADDR, false > rs1_addr, ac_int < REG_ADDR, false > rs2_addr) {
+        decode_memo_t & entry = memo[fetch_in.pc.to_uint()];
+        entry.instr_data = fetch_in.instr_data.to_uint();
+        entry.fused_instr = fetch_in.fused_instr.to_uint();
+        entry.fuse = fuse.to_uint();
+        entry.rs1_addr = rs1_addr;
+        entry.rs2_addr = rs2_addr;
+        entry.control = output;
+        entry.debug = debug_dout_t;
+        memo_last = &entry;
+    }
+
+    void memo_restore(const decode_memo_t & entry) {
+        output.dest_reg = entry.control.dest_reg;
+        output.imm_u = entry.control.imm_u;
+        output.alu_op = entry.control.alu_op;
+        output.alu_src = entry.control.alu_src;
+        output.regwrite = entry.control.regwrite;
+        output.memtoreg = entry.control.memtoreg;
+        output.ld = entry.control.ld;
+        output.st = entry.control.st;
+        trap = entry.trap;
+        trap_cause = entry.trap_cause;
+        debug_dout_t.regwrite = entry.debug.regwrite;
+        debug_dout_t.memtoreg = entry.debug.memtoreg;
+        debug_dout_t.ld = entry.debug.ld;
+        debug_dout_t.st = entry.debug.st;
+        debug_dout_t.alu_op = entry.debug.alu_op;
+        debug_dout_t.alu_src = entry.debug.alu_src;
+        debug_dout_t.dest_reg = entry.debug.dest_reg;
+        debug_dout_t.imm_u = entry.debug.imm_u;
     }
+    #endif
 
-    // --- End of utility functions.
 };
 
 #endif
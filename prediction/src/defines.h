@@ -28,7 +28,9 @@
 #define DATA_WIDTH 32 
 #define ADDR_WIDTH 32
 #define TAG_WIDTH 4
-#define SENTINEL_INIT (1 << (TAG_WIDTH - 1))
+#define SB_TAGS (1 << TAG_WIDTH) // In-flight register writes tracked by the decode scoreboard
+#define SB_COUNT_WIDTH (TAG_WIDTH + 1) // Up to SB_TAGS writes of the same register
+#define ID_WIDTH 3 // Issue slot ids, more than the instructions between issue and writeback
 #define FWD_ENABLE
 
 // Data cache directives
@@ -58,26 +60,144 @@
 // ( ADDR_WIDTH - ICACHE_INDEX_WIDTH - ICACHE_OFFSET_WIDTH )
 #define ICACHE_TAG_WIDTH 28
 
+#define ICACHE_LINE_WORDS ( ICACHE_LINE / DATA_WIDTH ) // Instructions per block
+#define PREDECODE_IMM_WIDTH 21 // JAL offset width, branch offsets are sign-extended to it
+
 #define ICACHE_DATA_SIZE ( ICACHE_WAYS * ICACHE_LINE )
 #define ICACHE_TAGS_SIZE ( ICACHE_WAYS * ICACHE_TAG_WIDTH + 2 * ICACHE_WAYS) // Contais the tags and the valid/dirty bits
-#define ICACHE_BUFFER_SIZE ( ICACHE_LINE / ADDR_WIDTH  + 1)
 
 // Branch predictor directives
-
-#define BTB_ENTRIES 32
+// The guarded sizes can be overridden from the command line, e.g. to sweep
+// them with prediction/tools/bpeval. A size and its width go together, the
+// way widths are derived with WAYS_WIDTH.
+
+// L0 BTB, fully associative with full tags
+#define BTB_L0_ENTRIES 4
+#define BTB_L0_INDEX_WIDTH WAYS_WIDTH(BTB_L0_ENTRIES)
+
+// L1 BTB, set associative with partial tags
+#ifndef BTB_WAYS
+#define BTB_WAYS 2 // Number of ways
+#endif
+#define BTB_WAYS_WIDTH WAYS_WIDTH(BTB_WAYS)
+#ifndef BTB_ENTRIES
+#define BTB_ENTRIES 32 // Number of sets
 // ( (int) log2( BTB_ENTRIES ) )
 #define BTB_INDEX_WIDTH 5
-// ( ADDR_WIDTH - BTB_INDEX_WIDTH )
-#define BTB_TAG_WIDTH 27
+#endif
+#ifndef BTB_TAG_WIDTH
+#define BTB_TAG_WIDTH 10 // Partial tag, aliases are caught by decode like any misprediction
+#endif
+#define BTB_REPL_POLICY REPL_LRU // Also used for the L0 BTB
+
+#ifndef BTB_PREDICTION_BITS_WIDTH
 #define BTB_PREDICTION_BITS_WIDTH 2 // Number of prediction bits used
+#endif
 // (2^BTB_PREDICTION_BITS_WIDTH / 2) - 1
-#define WEAK_NON_TAKEN 1 // Branches with certainty of <= WEAK_NON_TAKEN are not taken
-#define STRONG_TAKEN 3 // Maximum value for prediction bits
+#define WEAK_NON_TAKEN ( (1 << (BTB_PREDICTION_BITS_WIDTH - 1)) - 1 ) // Branches with certainty of <= WEAK_NON_TAKEN are not taken
+#define STRONG_TAKEN ( (1 << BTB_PREDICTION_BITS_WIDTH) - 1 ) // Maximum value for prediction bits
+
+// Direction predictors, the BTB only holds the branch targets
+#define DIR_PRED_BIMODAL 0 // One 2-bit counter per branch
+#define DIR_PRED_GSHARE 1 // 2-bit counters indexed by pc XOR global history
+#define DIR_PRED_TOURNAMENT 2 // Bimodal and gshare with a per-branch chooser
+#define DIR_PRED_TAGE 3 // Bimodal base and TAGE_TABLES tagged tables with geometric histories
+
+#ifndef DIR_PRED_POLICY
+#define DIR_PRED_POLICY DIR_PRED_BIMODAL
+#endif
+#ifndef DIR_PRED_ENTRIES
+#define DIR_PRED_ENTRIES 256 // Counters per table
+// ( (int) log2( DIR_PRED_ENTRIES ) )
+#define DIR_PRED_INDEX_WIDTH 8
+#endif
+#ifndef DIR_PRED_HISTORY_WIDTH
+#define DIR_PRED_HISTORY_WIDTH 8 // Global history bits for DIR_PRED_GSHARE and DIR_PRED_TOURNAMENT
+#endif
+
+// DIR_PRED_TAGE directives, DIR_PRED_INDEX_WIDTH sizes the base predictor
+#define TAGE_TABLES 4 // Tagged tables
+#define TAGE_ENTRIES 64 // Entries per tagged table
+// ( (int) log2( TAGE_ENTRIES ) )
+#define TAGE_INDEX_WIDTH 6
+#define TAGE_TAG_WIDTH 8
+#define TAGE_COUNTER_WIDTH 3
+#define TAGE_USEFUL_WIDTH 2
+#ifndef TAGE_MIN_HISTORY
+#define TAGE_MIN_HISTORY 4 // History of table t is TAGE_MIN_HISTORY << t
+// ( TAGE_MIN_HISTORY << (TAGE_TABLES - 1) )
+#define TAGE_HISTORY_WIDTH 32
+#endif
+
+// Loop-exit predictor, overrides the direction predictor on the last iteration of counted loops
+#define LOOP_PREDICTOR 1
+#define LOOP_PRED_ENTRIES 8
+// ( (int) log2( LOOP_PRED_ENTRIES ) )
+#define LOOP_PRED_INDEX_WIDTH 3
+#define LOOP_PRED_TAG_WIDTH 8
+#define LOOP_PRED_ITER_WIDTH 10 // Longest trip count tracked is 2^LOOP_PRED_ITER_WIDTH - 1
+#define LOOP_PRED_CONFIDENCE 2 // Complete runs with the same trip count before overriding
+
+// Loop buffer directives
+#define LOOP_BUFFER 1 // Replay short backward-branch loops from the loop buffer
+#define LOOP_BUFFER_ENTRIES 16 // Maximum number of instructions in a loop body
+// ( (int) log2( LOOP_BUFFER_ENTRIES ) )
+#define LOOP_BUFFER_INDEX_WIDTH 4
+
+// Indirect jump target predictor, for the JALRs that are not returns
+#define INDIRECT_PREDICTOR 1
+#ifndef IND_PRED_ENTRIES
+#define IND_PRED_ENTRIES 16
+// ( (int) log2( IND_PRED_ENTRIES ) )
+#define IND_PRED_INDEX_WIDTH 4
+#endif
+#define IND_PRED_TAG_WIDTH 8
+#define IND_PRED_PATH_BITS 2 // Target bits shifted into the path history per indirect jump
+#define IND_PRED_PATH_WIDTH 8 // Path history of the last 4 indirect jumps
 
 // RAS directives
-#define RAS_ENTRIES 4
+#ifndef RAS_ENTRIES
+#define RAS_ENTRIES 8 // Circular, deeper call chains overwrite the oldest entries
 // ( (int) log2( RAS_ENTRIES ) )
-#define RAS_POINTER_SIZE 2
+#define RAS_POINTER_SIZE 3
+#endif
+
+#define BRANCH_PROFILE_TOP 10 // Branches with the most flushed cycles reported at the end of the simulation
+
+#define MACRO_OP_FUSION 1 // Fuse common instruction pairs into one operation at fetch and decode
+#define FUSE_WIDTH 3
+
+// Deeper pipeline: decode and register read/issue are two stages, see issue.h.
+// Shorter decode path at the cost of one more cycle per misprediction.
+//#define DECODE_SPLIT 1
+
+#define MOVE_ELIMINATION 1 // Moves of a register still in flight take the scoreboard tag of its producer
+
+#define DECODE_MEMO 1 // Simulation only: decode reuses the control word of the instructions decoded before
+
+#define ICACHE_LINE_REUSE 1 // Fetches from the line of the previous fetch skip the I$ arrays
+
+#define ICACHE_WAY_PREDICTION 1 // Read only the predicted I$ way, one cycle penalty on a wrong prediction
+
+// Cache replacement policies
+#define REPL_LRU 0 // True LRU, log2(ways) age bits per way
+#define REPL_PLRU 1 // Tree pseudo-LRU, ways - 1 bits per set (ways must be a power of 2)
+#define REPL_FIFO 2 // Round-robin, log2(ways) bits per set
+#define REPL_RANDOM 3 // LFSR based, 16 bits per set
+#define REPL_SRRIP 4 // Static RRIP, REPL_RRPV_WIDTH bits per way
+
+#define REPL_RRPV_WIDTH 2 // Re-reference prediction value bits for REPL_SRRIP
+
+#define ICACHE_REPL_POLICY REPL_LRU
+#define DCACHE_REPL_POLICY REPL_LRU
+
+// Bits to address one of WAYS ways, ( (int) log2( WAYS ) ) rounded up and
+// at least 1, for up to 16 ways. The users check it against repl_way_width.
+#define WAYS_WIDTH(WAYS) ( (WAYS) > 8 ? 4 : (WAYS) > 4 ? 3 : (WAYS) > 2 ? 2 : 1 )
+
+#define ICACHE_WAYS_WIDTH WAYS_WIDTH(ICACHE_WAYS)
+#define DCACHE_WAYS_WIDTH WAYS_WIDTH(DCACHE_WAYS)
+
 // Dbg directives.
 
 #define INTERNAL_PROG // When on specifies the program to execute as an array in the fetch stage (not for production).
@@ -0,0 +1,469 @@
+/*
+	@author VLSI Lab, EE dept., Democritus University of Thrace
+
+	@brief Header file for the branch direction predictors
+
+	@note
+		- The direction predictors are separate from the BTB, which only
+		  holds the branch targets.
+
+		- All predictors share the same interface:
+			reset()            initializes the tables
+			predict(pc)        returns true if the branch at pc is predicted taken
+			speculate(taken)   shifts the direction fetched for a branch into
+			                   the speculative global history
+			repair()           restores the speculative history from the
+			                   resolved one after a redirect
+			update(pc, taken)  trains the predictor with the resolved direction
+
+		- predict() indexes with the speculative history, update() with the
+		  resolved one, which holds the history seen by the branch at fetch.
+
+		- The predictor is selected in defines.h with DIR_PRED_POLICY.
+
+		- Only ac_int is used, so the predictors can also be compiled on
+		  the host without SystemC.
+
+*/
+
+#ifndef __DIRECTION__H
+#define __DIRECTION__H
+
+#include "defines.h"
+#include "globals.h"
+
+#include <ac_int.h>
+
+typedef ac_int < PC_LEN, false > dir_pc_t;
+typedef ac_int < BTB_PREDICTION_BITS_WIDTH, false > dir_counter_t;
+
+// Saturating update of a prediction counter.
+inline dir_counter_t dir_counter_update(dir_counter_t counter, bool taken) {
+    if (taken && counter < STRONG_TAKEN) {
+        counter = counter + 1;
+    } else if (!taken && counter > 0) {
+        counter = counter - 1;
+    }
+    return counter;
+}
+
+inline bool dir_counter_taken(dir_counter_t counter) {
+    return counter > WEAK_NON_TAKEN;
+}
+
+// ------------ Bimodal
+// One counter per branch, indexed by the low pc bits (instructions are
+// word aligned, so bits 1:0 are skipped).
+template < int INDEX_WIDTH >
+struct bimodal_pred_t {
+    static const int ENTRIES = 1 << INDEX_WIDTH;
+
+    dir_counter_t counter[ENTRIES];
+
+    void reset() {
+        for (int i = 0; i < ENTRIES; i++) {
+            counter[i] = WEAK_NON_TAKEN;
+        }
+    }
+
+    ac_int < INDEX_WIDTH, false > index(dir_pc_t pc) {
+        return pc.slc < INDEX_WIDTH > (2);
+    }
+
+    bool predict(dir_pc_t pc) {
+        return dir_counter_taken(counter[index(pc)]);
+    }
+
+    void speculate(bool taken) {
+    }
+
+    void repair() {
+    }
+
+    void update(dir_pc_t pc, bool taken) {
+        ac_int < INDEX_WIDTH, false > i = index(pc);
+        counter[i] = dir_counter_update(counter[i], taken);
+    }
+};
+
+// ------------ Gshare
+// Counters indexed by the pc XOR the global history of the last
+// HISTORY_WIDTH resolved branches.
+template < int INDEX_WIDTH, int HISTORY_WIDTH >
+struct gshare_pred_t {
+    static const int ENTRIES = 1 << INDEX_WIDTH;
+
+    dir_counter_t counter[ENTRIES];
+    ac_int < HISTORY_WIDTH, false > spec_ghr; // Directions fetched
+    ac_int < HISTORY_WIDTH, false > ghr; // Directions resolved
+
+    void reset() {
+        for (int i = 0; i < ENTRIES; i++) {
+            counter[i] = WEAK_NON_TAKEN;
+        }
+        spec_ghr = 0;
+        ghr = 0;
+    }
+
+    ac_int < INDEX_WIDTH, false > index(dir_pc_t pc, ac_int < HISTORY_WIDTH, false > ghist) {
+        ac_int < INDEX_WIDTH, false > history = ghist;
+        return pc.slc < INDEX_WIDTH > (2) ^ history;
+    }
+
+    bool predict(dir_pc_t pc) {
+        return dir_counter_taken(counter[index(pc, spec_ghr)]);
+    }
+
+    void speculate(bool taken) {
+        spec_ghr = (spec_ghr << 1) | (taken ? 1 : 0);
+    }
+
+    void repair() {
+        spec_ghr = ghr;
+    }
+
+    // Prediction with the resolved history, used when training.
+    bool resolved_predict(dir_pc_t pc) {
+        return dir_counter_taken(counter[index(pc, ghr)]);
+    }
+
+    void update(dir_pc_t pc, bool taken) {
+        ac_int < INDEX_WIDTH, false > i = index(pc, ghr);
+        counter[i] = dir_counter_update(counter[i], taken);
+        ghr = (ghr << 1) | (taken ? 1 : 0);
+    }
+};
+
+// ------------ Tournament
+// Bimodal and gshare side by side, a per-branch chooser counter selects
+// gshare when it is above WEAK_NON_TAKEN. The chooser is trained only when
+// the two components disagree.
+template < int INDEX_WIDTH, int HISTORY_WIDTH >
+struct tournament_pred_t {
+    static const int ENTRIES = 1 << INDEX_WIDTH;
+
+    bimodal_pred_t < INDEX_WIDTH > bimodal;
+    gshare_pred_t < INDEX_WIDTH, HISTORY_WIDTH > gshare;
+    dir_counter_t chooser[ENTRIES];
+
+    void reset() {
+        bimodal.reset();
+        gshare.reset();
+        for (int i = 0; i < ENTRIES; i++) {
+            chooser[i] = WEAK_NON_TAKEN;
+        }
+    }
+
+    bool predict(dir_pc_t pc) {
+        bool use_gshare = dir_counter_taken(chooser[bimodal.index(pc)]);
+        return use_gshare ? gshare.predict(pc) : bimodal.predict(pc);
+    }
+
+    void speculate(bool taken) {
+        gshare.speculate(taken);
+    }
+
+    void repair() {
+        gshare.repair();
+    }
+
+    void update(dir_pc_t pc, bool taken) {
+        ac_int < INDEX_WIDTH, false > i = bimodal.index(pc);
+        bool bimodal_taken = bimodal.predict(pc);
+        bool gshare_taken = gshare.resolved_predict(pc);
+
+        if (bimodal_taken != gshare_taken) {
+            chooser[i] = dir_counter_update(chooser[i], gshare_taken == taken);
+        }
+        bimodal.update(pc, taken);
+        gshare.update(pc, taken);
+    }
+};
+
+// ------------ TAGE-lite
+// A bimodal base predictor plus TABLES tagged tables, table t is indexed
+// and tagged with the last TAGE_MIN_HISTORY << t directions. The longest
+// matching table provides the prediction, the next matching one (or the
+// base) is the alternate prediction. Useful bits count how often the
+// provider was right where the alternate was wrong, and protect the entry
+// from being replaced when a misprediction allocates in a longer table.
+template < int TABLES, int INDEX_WIDTH, int TAG_BITS >
+struct tage_pred_t {
+    static const int ENTRIES = 1 << INDEX_WIDTH;
+    static const int CTR_MAX = (1 << TAGE_COUNTER_WIDTH) - 1;
+    static const int CTR_WEAK_TAKEN = 1 << (TAGE_COUNTER_WIDTH - 1);
+    static const int USEFUL_MAX = (1 << TAGE_USEFUL_WIDTH) - 1;
+
+    typedef ac_int < TAGE_HISTORY_WIDTH, false > tage_history_t;
+    typedef ac_int < INDEX_WIDTH, false > tage_index_t;
+    typedef ac_int < TAG_BITS, false > tage_tag_t;
+
+    // Result of the lookup of one branch in all the tables
+    struct tage_lookup_t {
+        int provider; // Longest matching table, -1 for the base predictor
+        bool provider_taken;
+        bool alt_taken;
+        tage_index_t index[TABLES];
+        tage_tag_t tag[TABLES];
+    };
+
+    bimodal_pred_t < DIR_PRED_INDEX_WIDTH > base;
+    ac_int < TAGE_COUNTER_WIDTH, false > tage_ctr[TABLES][ENTRIES];
+    tage_tag_t tage_tag[TABLES][ENTRIES];
+    ac_int < TAGE_USEFUL_WIDTH, false > tage_useful[TABLES][ENTRIES];
+
+    tage_history_t spec_ghr; // Directions fetched
+    tage_history_t ghr; // Directions resolved
+
+    void reset() {
+        base.reset();
+        for (int t = 0; t < TABLES; t++) {
+            for (int i = 0; i < ENTRIES; i++) {
+                tage_ctr[t][i] = CTR_WEAK_TAKEN - 1;
+                tage_tag[t][i] = 0;
+                tage_useful[t][i] = 0;
+            }
+        }
+        spec_ghr = 0;
+        ghr = 0;
+    }
+
+    // XOR of the pc bits with the first length history bits folded to W bits.
+    template < int W >
+    ac_int < W, false > fold(ac_int < W, false > pc_bits, tage_history_t history, int length, int shift) {
+        ac_int < W, false > folded = pc_bits;
+        #pragma unroll yes
+        for (int b = 0; b < TAGE_HISTORY_WIDTH; b++) {
+            if (b < length) {
+                int bit = (b + shift) % W;
+                folded[bit] = folded[bit] ^ history[b];
+            }
+        }
+        return folded;
+    }
+
+    void lookup(dir_pc_t pc, tage_history_t history, tage_lookup_t & l) {
+        bool base_taken = base.predict(pc);
+        l.provider = -1;
+        l.provider_taken = base_taken;
+        l.alt_taken = base_taken;
+
+        #pragma unroll yes
+        for (int t = 0; t < TABLES; t++) {
+            int length = TAGE_MIN_HISTORY << t;
+            l.index[t] = fold < INDEX_WIDTH > (pc.slc < INDEX_WIDTH > (2), history, length, 0);
+            l.tag[t] = fold < TAG_BITS > (pc.slc < TAG_BITS > (2 + INDEX_WIDTH), history, length, 1);
+
+            if (tage_tag[t][l.index[t]] == l.tag[t]) {
+                l.alt_taken = l.provider_taken;
+                l.provider_taken = tage_ctr[t][l.index[t]] >= CTR_WEAK_TAKEN;
+                l.provider = t;
+            }
+        }
+    }
+
+    bool predict(dir_pc_t pc) {
+        tage_lookup_t l;
+        lookup(pc, spec_ghr, l);
+        return l.provider_taken;
+    }
+
+    void speculate(bool taken) {
+        spec_ghr = (spec_ghr << 1) | (taken ? 1 : 0);
+    }
+
+    void repair() {
+        spec_ghr = ghr;
+    }
+
+    void update(dir_pc_t pc, bool taken) {
+        tage_lookup_t l;
+        lookup(pc, ghr, l);
+
+        if (l.provider >= 0) {
+            int t = l.provider;
+            tage_index_t i = l.index[t];
+            if (taken && tage_ctr[t][i] < CTR_MAX) {
+                tage_ctr[t][i] = tage_ctr[t][i] + 1;
+            } else if (!taken && tage_ctr[t][i] > 0) {
+                tage_ctr[t][i] = tage_ctr[t][i] - 1;
+            }
+
+            if (l.provider_taken != l.alt_taken) {
+                if (l.provider_taken == taken && tage_useful[t][i] < USEFUL_MAX) {
+                    tage_useful[t][i] = tage_useful[t][i] + 1;
+                } else if (l.provider_taken != taken && tage_useful[t][i] > 0) {
+                    tage_useful[t][i] = tage_useful[t][i] - 1;
+                }
+            }
+        } else {
+            base.update(pc, taken);
+        }
+
+        // On a misprediction allocate one entry in a longer table, or age
+        // the entries that could not be replaced
+        if (l.provider_taken != taken) {
+            bool allocated = false;
+            #pragma unroll yes
+            for (int t = 0; t < TABLES; t++) {
+                if (t > l.provider && !allocated && tage_useful[t][l.index[t]] == 0) {
+                    tage_tag[t][l.index[t]] = l.tag[t];
+                    tage_ctr[t][l.index[t]] = taken ? CTR_WEAK_TAKEN : CTR_WEAK_TAKEN - 1;
+                    allocated = true;
+                }
+            }
+            if (!allocated) {
+                #pragma unroll yes
+                for (int t = 0; t < TABLES; t++) {
+                    if (t > l.provider) {
+                        tage_useful[t][l.index[t]] = tage_useful[t][l.index[t]] - 1;
+                    }
+                }
+            }
+        }
+
+        ghr = (ghr << 1) | (taken ? 1 : 0);
+    }
+};
+
+// ------------ Loop-exit predictor
+// Learns the trip count of backward branches: iterations counts the taken
+// outcomes of the running loop, trip those of the previous complete run.
+// Once the same trip count is seen LOOP_PRED_CONFIDENCE times in a row the
+// exit is predicted not taken, which a 2-bit counter always mispredicts.
+// Fetch runs ahead of the resolution, so the prediction counts the
+// iterations fetched in spec_iterations, like the speculative history of
+// the direction predictors.
+// It is consulted next to the direction predictor:
+//     confident(pc)                 the entry of pc overrides the direction predictor
+//     predict(pc)                   direction of the branch at pc
+//     speculate(pc, taken)          counts the direction fetched for the branch at pc
+//     repair()                      restores the fetched counts from the resolved ones
+//     update(pc, taken, backward)   trains the entry, allocating on loop exits
+template < int INDEX_WIDTH >
+struct loop_pred_t {
+    static const int ENTRIES = 1 << INDEX_WIDTH;
+    static const int ITER_MAX = (1 << LOOP_PRED_ITER_WIDTH) - 1;
+    static const int CONFIDENCE_MAX = 3;
+
+    bool valid[ENTRIES];
+    ac_int < LOOP_PRED_TAG_WIDTH, false > tag[ENTRIES];
+    ac_int < LOOP_PRED_ITER_WIDTH, false > trip[ENTRIES];
+    ac_int < LOOP_PRED_ITER_WIDTH, false > iterations[ENTRIES]; // Resolved
+    ac_int < LOOP_PRED_ITER_WIDTH, false > spec_iterations[ENTRIES]; // Fetched
+    ac_int < 2, false > confidence[ENTRIES];
+
+    void reset() {
+        for (int i = 0; i < ENTRIES; i++) {
+            valid[i] = false;
+            tag[i] = 0;
+            trip[i] = 0;
+            iterations[i] = 0;
+            spec_iterations[i] = 0;
+            confidence[i] = 0;
+        }
+    }
+
+    ac_int < INDEX_WIDTH, false > index(dir_pc_t pc) {
+        return pc.slc < INDEX_WIDTH > (2);
+    }
+
+    ac_int < LOOP_PRED_TAG_WIDTH, false > entry_tag(dir_pc_t pc) {
+        return pc.slc < LOOP_PRED_TAG_WIDTH > (2 + INDEX_WIDTH);
+    }
+
+    bool hit(dir_pc_t pc) {
+        ac_int < INDEX_WIDTH, false > i = index(pc);
+        return valid[i] && tag[i] == entry_tag(pc);
+    }
+
+    bool confident(dir_pc_t pc) {
+        return hit(pc) && confidence[index(pc)] >= LOOP_PRED_CONFIDENCE;
+    }
+
+    bool predict(dir_pc_t pc) {
+        ac_int < INDEX_WIDTH, false > i = index(pc);
+        return spec_iterations[i] != trip[i];
+    }
+
+    void speculate(dir_pc_t pc, bool taken) {
+        ac_int < INDEX_WIDTH, false > i = index(pc);
+        if (hit(pc)) {
+            if (!taken) {
+                spec_iterations[i] = 0;
+            } else if (spec_iterations[i] != ITER_MAX) {
+                spec_iterations[i] = spec_iterations[i] + 1;
+            }
+        }
+    }
+
+    void repair() {
+        #pragma unroll yes
+        for (int i = 0; i < ENTRIES; i++) {
+            spec_iterations[i] = iterations[i];
+        }
+    }
+
+    void update(dir_pc_t pc, bool taken, bool backward) {
+        ac_int < INDEX_WIDTH, false > i = index(pc);
+
+        if (hit(pc)) {
+            if (taken && iterations[i] == ITER_MAX) {
+                valid[i] = false; // Trip count too long to be tracked
+            } else if (taken) {
+                if (iterations[i] == trip[i]) {
+                    confidence[i] = 0; // The loop ran longer than learned
+                }
+                iterations[i] = iterations[i] + 1;
+            } else {
+                if (iterations[i] == trip[i]) {
+                    if (confidence[i] < CONFIDENCE_MAX) {
+                        confidence[i] = confidence[i] + 1;
+                    }
+                } else {
+                    trip[i] = iterations[i];
+                    confidence[i] = 0;
+                }
+                iterations[i] = 0;
+            }
+        } else if (backward && !taken) {
+            // Allocate on the exit of a loop, confident entries are aged first
+            if (!valid[i] || confidence[i] == 0) {
+                valid[i] = true;
+                tag[i] = entry_tag(pc);
+                trip[i] = 0;
+                iterations[i] = 0;
+                spec_iterations[i] = 0;
+                confidence[i] = 0;
+            } else {
+                confidence[i] = confidence[i] - 1;
+            }
+        }
+    }
+};
+
+// ------------ Predictor selection
+template < int POLICY >
+struct dir_pred_select;
+
+template < >
+struct dir_pred_select < DIR_PRED_BIMODAL > {
+    typedef bimodal_pred_t < DIR_PRED_INDEX_WIDTH > type;
+};
+
+template < >
+struct dir_pred_select < DIR_PRED_GSHARE > {
+    typedef gshare_pred_t < DIR_PRED_INDEX_WIDTH, DIR_PRED_HISTORY_WIDTH > type;
+};
+
+template < >
+struct dir_pred_select < DIR_PRED_TOURNAMENT > {
+    typedef tournament_pred_t < DIR_PRED_INDEX_WIDTH, DIR_PRED_HISTORY_WIDTH > type;
+};
+
+template < >
+struct dir_pred_select < DIR_PRED_TAGE > {
+    typedef tage_pred_t < TAGE_TABLES, TAGE_INDEX_WIDTH, TAGE_TAG_WIDTH > type;
+};
+
+#endif
@@ -19,6 +19,9 @@
 
 #include "fetch.h"
 #include "decode.h"
+#ifdef DECODE_SPLIT
+#include "issue.h"
+#endif
 #include "execute.h"
 #include "writeback.h"
 
@@ -47,8 +50,11 @@ SC_MODULE(drim4hls) {
 
     // Inter-stage Channels and ports.
     Connections::Combinational < fe_out_t > CCS_INIT_S1(fe2de_ch);
+    #ifdef DECODE_SPLIT
+    Connections::Combinational < de_iss_t > CCS_INIT_S1(de2iss_ch);
+    #endif
     Connections::Combinational < de_out_t > CCS_INIT_S1(de2exe_ch);
-    Connections::Combinational < fe_in_t > CCS_INIT_S1(de2fe_ch);
+    Connections::Combinational < fe_in_t > CCS_INIT_S1(exe2fe_ch);
     Connections::Combinational < mem_out_t > CCS_INIT_S1(wb2de_ch); // Writeback loop
     Connections::Combinational < exe_out_t > CCS_INIT_S1(exe2mem_ch);
 
@@ -64,6 +70,9 @@ SC_MODULE(drim4hls) {
     // Instantiate the modules
     fetch CCS_INIT_S1(fe);
     decode CCS_INIT_S1(dec);
+    #ifdef DECODE_SPLIT
+    issue CCS_INIT_S1(iss);
+    #endif
     execute CCS_INIT_S1(exe);
     writeback CCS_INIT_S1(wb);
 
@@ -71,8 +80,11 @@ SC_MODULE(drim4hls) {
     rst("rst"),
     program_end("program_end"),
     fe2de_ch("fe2de_ch"),
+    #ifdef DECODE_SPLIT
+    de2iss_ch("de2iss_ch"),
+    #endif
     de2exe_ch("de2exe_ch"),
-    de2fe_ch("de2fe_ch"),
+    exe2fe_ch("exe2fe_ch"),
     exe2mem_ch("exe2mem_ch"),
     wb2de_ch("wb2de_ch"),
     fwd_exe_ch("fwd_exe_ch"),
@@ -82,6 +94,9 @@ SC_MODULE(drim4hls) {
     wb2dmem_data("wb2dmem_data"),
     fe("Fetch"),
     dec("Decode"),
+    #ifdef DECODE_SPLIT
+    iss("Issue"),
+    #endif
     exe("Execute"),
     wb("Writeback") {
         // FETCH
@@ -90,15 +105,31 @@ SC_MODULE(drim4hls) {
         fe.dout(fe2de_ch);
         fe.imem_din(fe2imem_data);
         fe.imem_dout(imem2de_data);
-        fe.fetch_din(de2fe_ch);
+        fe.fetch_din(exe2fe_ch);
 
         // DECODE
         dec.clk(clk);
         dec.rst(rst);
+        dec.fetch_din(fe2de_ch);
+        #ifdef DECODE_SPLIT
+        dec.dout(de2iss_ch);
+
+        // ISSUE
+        iss.clk(clk);
+        iss.rst(rst);
+        iss.din(de2iss_ch);
+        iss.dout(de2exe_ch);
+        iss.feed_from_wb(wb2de_ch);
+        iss.program_end(program_end);
+        iss.fwd_exe(fwd_exe_ch);
+        iss.icount(icount);
+        iss.j_icount(j_icount);
+        iss.b_icount(b_icount);
+        iss.m_icount(m_icount);
+        iss.o_icount(o_icount);
+        #else
         dec.dout(de2exe_ch);
         dec.feed_from_wb(wb2de_ch);
-        dec.fetch_din(fe2de_ch);
-        dec.fetch_dout(de2fe_ch);
         dec.program_end(program_end);
         dec.fwd_exe(fwd_exe_ch);
         dec.icount(icount);
@@ -106,6 +137,7 @@ SC_MODULE(drim4hls) {
         dec.b_icount(b_icount);
         dec.m_icount(m_icount);
         dec.o_icount(o_icount);
+        #endif
 
         // EXE
         exe.clk(clk);
@@ -113,6 +145,7 @@ SC_MODULE(drim4hls) {
         exe.din(de2exe_ch);
         exe.dout(exe2mem_ch);
         exe.fwd_exe(fwd_exe_ch);
+        exe.fetch_dout(exe2fe_ch);
 
         // MEM
         wb.clk(clk);
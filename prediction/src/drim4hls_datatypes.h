@@ -22,16 +22,17 @@
 #include "defines.h"
 #include "globals.h"
 
+#include <ac_int.h>
 #include <mc_connections.h>
 
 struct de_in_t {
     //
     // Member declarations.
     //
-    sc_uint < 1 > jump;
-    sc_uint < 1 > branch;
-    sc_uint < PC_LEN > jump_address;
-    sc_uint < PC_LEN > branch_address;
+    ac_int < 1, false > jump;
+    ac_int < 1, false > branch;
+    ac_int < PC_LEN, false > jump_address;
+    ac_int < PC_LEN, false > branch_address;
 
     static const int width = 2 + 2 * PC_LEN;
 
@@ -119,6 +120,245 @@ struct de_in_t {
 #endif
 // ------------ END de_in_t
 
+// ------------ predecode_t
+#ifndef predecode_t_SC_WRAPPER_TYPE
+#define predecode_t_SC_WRAPPER_TYPE 1
+
+struct predecode_t {
+    //
+    // Member declarations.
+    //
+    bool branch; // Conditional branch
+    bool jal;
+    bool jalr;
+    bool call; // JAL/JALR that writes a link register (x1/x5)
+    bool ret; // JALR that reads a link register and does not write one
+    bool ldst; // Load or store
+    bool multicycle; // Multiplication or division
+    ac_int < PREDECODE_IMM_WIDTH, false > imm; // Sign-extended offset of the JAL/branch target
+
+    static const int width = 7 + PREDECODE_IMM_WIDTH;
+
+    //
+    // Default constructor.
+    //
+    predecode_t() {
+        branch = false;
+        jal = false;
+        jalr = false;
+        call = false;
+        ret = false;
+        ldst = false;
+        multicycle = false;
+        imm = 0;
+    }
+
+    //
+    // Copy constructor.
+    //
+    predecode_t(const predecode_t & other) {
+        branch = other.branch;
+        jal = other.jal;
+        jalr = other.jalr;
+        call = other.call;
+        ret = other.ret;
+        ldst = other.ldst;
+        multicycle = other.multicycle;
+        imm = other.imm;
+    }
+
+    //
+    // Comparison operator.
+    //
+    inline bool operator == (const predecode_t & other) {
+        if (!(branch == other.branch))
+            return false;
+        if (!(jal == other.jal))
+            return false;
+        if (!(jalr == other.jalr))
+            return false;
+        if (!(call == other.call))
+            return false;
+        if (!(ret == other.ret))
+            return false;
+        if (!(ldst == other.ldst))
+            return false;
+        if (!(multicycle == other.multicycle))
+            return false;
+        if (!(imm == other.imm))
+            return false;
+        return true;
+    }
+
+    //
+    // Assignment operator from predecode_t.
+    //
+    inline predecode_t & operator = (const predecode_t & other) {
+        branch = other.branch;
+        jal = other.jal;
+        jalr = other.jalr;
+        call = other.call;
+        ret = other.ret;
+        ldst = other.ldst;
+        multicycle = other.multicycle;
+        imm = other.imm;
+        return *this;
+    }
+
+    //
+    // Packed representation, fields from the lsb in declaration order.
+    //
+    template < int W >
+    inline void pack(ac_int < W, false > & bits, int & pos) const {
+        pack_field(bits, pos, branch);
+        pack_field(bits, pos, jal);
+        pack_field(bits, pos, jalr);
+        pack_field(bits, pos, call);
+        pack_field(bits, pos, ret);
+        pack_field(bits, pos, ldst);
+        pack_field(bits, pos, multicycle);
+        pack_field(bits, pos, imm);
+    }
+
+    template < int W >
+    inline void unpack(const ac_int < W, false > & bits, int & pos) {
+        unpack_field(bits, pos, branch);
+        unpack_field(bits, pos, jal);
+        unpack_field(bits, pos, jalr);
+        unpack_field(bits, pos, call);
+        unpack_field(bits, pos, ret);
+        unpack_field(bits, pos, ldst);
+        unpack_field(bits, pos, multicycle);
+        unpack_field(bits, pos, imm);
+    }
+
+    template < unsigned int Size >
+        void Marshall(Marshaller < Size > & m) {
+            m & branch;
+            m & jal;
+            m & jalr;
+            m & call;
+            m & ret;
+            m & ldst;
+            m & multicycle;
+            m & imm;
+        }
+
+    //
+    // sc_trace function.
+    //
+    inline friend void sc_trace(sc_trace_file * tf, const predecode_t & object, const std::string & in_name) {
+        sc_trace(tf, object.branch, in_name + std::string(".branch"));
+        sc_trace(tf, object.jal, in_name + std::string(".jal"));
+        sc_trace(tf, object.jalr, in_name + std::string(".jalr"));
+        sc_trace(tf, object.call, in_name + std::string(".call"));
+        sc_trace(tf, object.ret, in_name + std::string(".ret"));
+        sc_trace(tf, object.ldst, in_name + std::string(".ldst"));
+        sc_trace(tf, object.multicycle, in_name + std::string(".multicycle"));
+        sc_trace(tf, object.imm, in_name + std::string(".imm"));
+    }
+
+    //
+    // stream operator.
+    //
+    inline friend ostream & operator << (ostream & os,
+        const predecode_t & object) {
+
+        os << "(";
+        os << object.branch;
+        os << object.jal;
+        os << object.jalr;
+        os << object.call;
+        os << object.ret;
+        os << object.ldst;
+        os << object.multicycle;
+        os << object.imm;
+        os << ")";
+
+        return os;
+    }
+
+};
+
+#endif
+// ------------ END predecode_t
+
+// Packed transport
+// ------------ pack_field
+#ifndef pack_field_SC_WRAPPER_TYPE
+#define pack_field_SC_WRAPPER_TYPE 1
+
+// The payloads of the pipeline channels are marshalled as one ac_int, every
+// field is a fixed slice of it. pos is the lsb of the field, it is advanced
+// past the field so the slices follow the declaration order. The positions
+// are constants once the calls are inlined, packing is only wiring.
+template < int W, int F, bool S >
+inline void pack_field(ac_int < W, false > & bits, int & pos, const ac_int < F, S > & field) {
+    bits.set_slc(pos, field);
+    pos += F;
+}
+
+template < int W >
+inline void pack_field(ac_int < W, false > & bits, int & pos, bool field) {
+    bits.set_slc(pos, ac_int < 1, false > (field));
+    pos += 1;
+}
+
+// Structs, see their pack()
+template < int W, typename T >
+inline void pack_field(ac_int < W, false > & bits, int & pos, const T & field) {
+    field.pack(bits, pos);
+}
+
+template < int W, int F, bool S >
+inline void unpack_field(const ac_int < W, false > & bits, int & pos, ac_int < F, S > & field) {
+    field = bits.template slc < F > (pos);
+    pos += F;
+}
+
+template < int W >
+inline void unpack_field(const ac_int < W, false > & bits, int & pos, bool & field) {
+    field = (bits.template slc < 1 > (pos) == 1);
+    pos += 1;
+}
+
+template < int W, typename T >
+inline void unpack_field(const ac_int < W, false > & bits, int & pos, T & field) {
+    field.unpack(bits, pos);
+}
+
+#ifndef __SYNTHESIS__
+// Self-test of a payload type, run once by the testbench before the
+// simulation. pack() has to fill exactly width bits, and any packed value
+// has to come back unchanged through unpack() and pack().
+template < typename T >
+inline bool pack_round_trip() {
+    T object;
+    ac_int < T::width, false > bits = 0;
+    int pos = 0;
+    object.pack(bits, pos);
+    bool ok = (pos == T::width);
+    unsigned int lfsr = 0xACE1u;
+    for (int n = 0; n < 64 && ok; n++) {
+        for (int i = 0; i < T::width; i++) {
+            lfsr = (lfsr >> 1) ^ ((lfsr & 1) ? 0xB4BCD35Cu : 0);
+            bits.set_slc(i, (ac_int < 1, false >)((n == 0) ? 1 : (lfsr & 1)));
+        }
+        T copy;
+        ac_int < T::width, false > again = 0;
+        pos = 0;
+        copy.unpack(bits, pos);
+        pos = 0;
+        copy.pack(again, pos);
+        ok = (again == bits);
+    }
+    return ok;
+}
+#endif
+
+#endif
+// ------------ END pack_field
+
 // ------------ fe_out_t
 #ifndef fe_out_t_SC_WRAPPER_TYPE
 #define fe_out_t_SC_WRAPPER_TYPE 1
@@ -127,10 +367,17 @@ struct fe_out_t {
     //
     // Member declarations.
     //
-    sc_uint < PC_LEN > pc;
-    sc_uint < XLEN > instr_data;
+    ac_int < PC_LEN, false > pc;
+    ac_int < XLEN, false > instr_data;
+    predecode_t predecode;
+    ac_int < RAS_POINTER_SIZE, false > ras_top; // RAS state after this instruction, restored on a redirect
+    ac_int < PC_LEN, false > ras_tos;
+    ac_int < PC_LEN, false > next_pc; // Predicted pc of the next instruction
+    ac_int < TAG_WIDTH, false > tag; // Fetch epoch, squashed by decode when it is stale
+    ac_int < FUSE_WIDTH, false > fuse; // Fused with the next instruction, see globals.h
+    ac_int < XLEN, false > fused_instr; // Second instruction of the fused pair
 
-    static const int width = PC_LEN + XLEN;
+    static const int width = PC_LEN + XLEN + predecode_t::width + RAS_POINTER_SIZE + PC_LEN + TAG_WIDTH + PC_LEN + FUSE_WIDTH + XLEN;
 
     //
     // Default constructor.
@@ -138,6 +385,12 @@ struct fe_out_t {
     fe_out_t() {
         pc = 0;
         instr_data = 0;
+        ras_top = 0;
+        ras_tos = 0;
+        next_pc = 0;
+        tag = 0;
+        fuse = FUSE_NONE;
+        fused_instr = 0;
     }
 
     //
@@ -146,6 +399,13 @@ struct fe_out_t {
     fe_out_t(const fe_out_t & other) {
         pc = other.pc;
         instr_data = other.instr_data;
+        predecode = other.predecode;
+        ras_top = other.ras_top;
+        ras_tos = other.ras_tos;
+        next_pc = other.next_pc;
+        tag = other.tag;
+        fuse = other.fuse;
+        fused_instr = other.fused_instr;
     }
 
     //
@@ -156,6 +416,20 @@ struct fe_out_t {
             return false;
         if (!(instr_data == other.instr_data))
             return false;
+        if (!(predecode == other.predecode))
+            return false;
+        if (!(ras_top == other.ras_top))
+            return false;
+        if (!(ras_tos == other.ras_tos))
+            return false;
+        if (!(next_pc == other.next_pc))
+            return false;
+        if (!(tag == other.tag))
+            return false;
+        if (!(fuse == other.fuse))
+            return false;
+        if (!(fused_instr == other.fused_instr))
+            return false;
         return true;
     }
 
@@ -165,6 +439,13 @@ struct fe_out_t {
     inline fe_out_t & operator = (const fe_out_t & other) {
         pc = other.pc;
         instr_data = other.instr_data;
+        predecode = other.predecode;
+        ras_top = other.ras_top;
+        ras_tos = other.ras_tos;
+        next_pc = other.next_pc;
+        tag = other.tag;
+        fuse = other.fuse;
+        fused_instr = other.fused_instr;
         return *this;
     }
 
@@ -172,6 +453,13 @@ struct fe_out_t {
         void Marshall(Marshaller < Size > & m) {
             m & pc;
             m & instr_data;
+            m & predecode;
+            m & ras_top;
+            m & ras_tos;
+            m & next_pc;
+            m & tag;
+            m & fuse;
+            m & fused_instr;
         }
 
     //
@@ -180,6 +468,13 @@ struct fe_out_t {
     inline friend void sc_trace(sc_trace_file * tf, const fe_out_t & object, const std::string & in_name) {
         sc_trace(tf, object.pc, in_name + std::string(".pc"));
         sc_trace(tf, object.instr_data, in_name + std::string(".instr_data"));
+        sc_trace(tf, object.predecode, in_name + std::string(".predecode"));
+        sc_trace(tf, object.ras_top, in_name + std::string(".ras_top"));
+        sc_trace(tf, object.ras_tos, in_name + std::string(".ras_tos"));
+        sc_trace(tf, object.next_pc, in_name + std::string(".next_pc"));
+        sc_trace(tf, object.tag, in_name + std::string(".tag"));
+        sc_trace(tf, object.fuse, in_name + std::string(".fuse"));
+        sc_trace(tf, object.fused_instr, in_name + std::string(".fused_instr"));
     }
 
     //
@@ -191,6 +486,13 @@ struct fe_out_t {
         os << "(";
         os << object.pc;
         os << object.instr_data;
+        os << object.predecode;
+        os << object.ras_top;
+        os << object.ras_tos;
+        os << object.next_pc;
+        os << object.tag;
+        os << object.fuse;
+        os << object.fused_instr;
         os << ")";
 
         return os;
@@ -210,21 +512,28 @@ struct de_out_t {
     //
     // Member declarations.
     //
-    sc_uint < 1 > regwrite;
-    sc_uint < 1 > memtoreg;
-    sc_uint < 3 > ld;
-    sc_uint < 2 > st;
-    sc_uint < ALUOP_SIZE > alu_op;
-    sc_uint < ALUSRC_SIZE > alu_src;
-    sc_int < XLEN > rs1;
-    sc_int < XLEN > rs2;
-    sc_uint < REG_ADDR > dest_reg;
-    sc_uint < PC_LEN > pc;
-    sc_uint < XLEN - 12 > imm_u;
-    sc_uint < TAG_WIDTH > tag;
+    ac_int < 1, false > regwrite;
+    ac_int < 1, false > memtoreg;
+    ac_int < 3, false > ld;
+    ac_int < 2, false > st;
+    ac_int < ALUOP_SIZE, false > alu_op;
+    ac_int < ALUSRC_SIZE, false > alu_src;
+    ac_int < XLEN, true > rs1;
+    ac_int < XLEN, true > rs2;
+    ac_int < REG_ADDR, false > dest_reg;
+    ac_int < PC_LEN, false > pc;
+    ac_int < XLEN - 12, false > imm_u;
+    ac_int < TAG_WIDTH, false > tag; // Scoreboard tag of the destination register
+    ac_int < ID_WIDTH, false > id; // Issue slot, stands for the pc after execute
+    predecode_t predecode;
+    ac_int < PC_LEN, false > next_pc; // Predicted by the fetch, verified by execute
+    ac_int < RAS_POINTER_SIZE, false > ras_top; // RAS checkpoint taken at fetch
+    ac_int < PC_LEN, false > ras_tos;
+    ac_int < FUSE_WIDTH, false > fuse; // Fused pair, pc is the one of the second instruction
+    ac_int < 1, false > move; // ADDI rd, rs1, 0, issue may eliminate it
 
     static
-    const int width = 1 + 1 + 3 + 2 + ALUOP_SIZE + ALUSRC_SIZE + 3 * XLEN - 12 + REG_ADDR + PC_LEN + TAG_WIDTH;
+    const int width = 1 + 1 + 3 + 2 + ALUOP_SIZE + ALUSRC_SIZE + 3 * XLEN - 12 + REG_ADDR + PC_LEN + TAG_WIDTH + RAS_POINTER_SIZE + PC_LEN + PC_LEN + 4 + PREDECODE_IMM_WIDTH + FUSE_WIDTH + 1 + ID_WIDTH;
 
     //
     // Default constructor.
@@ -242,6 +551,12 @@ struct de_out_t {
         pc = 0;
         imm_u = 0;
         tag = 0;
+        id = 0;
+        next_pc = 0;
+        ras_top = 0;
+        ras_tos = 0;
+        fuse = FUSE_NONE;
+        move = 0;
     }
 
     //
@@ -260,6 +575,13 @@ struct de_out_t {
         pc = other.pc;
         imm_u = other.imm_u;
         tag = other.tag;
+        id = other.id;
+        predecode = other.predecode;
+        next_pc = other.next_pc;
+        ras_top = other.ras_top;
+        ras_tos = other.ras_tos;
+        fuse = other.fuse;
+        move = other.move;
     }
 
     //
@@ -290,6 +612,20 @@ struct de_out_t {
             return false;
         if (!(tag == other.tag))
             return false;
+        if (!(id == other.id))
+            return false;
+        if (!(predecode == other.predecode))
+            return false;
+        if (!(next_pc == other.next_pc))
+            return false;
+        if (!(ras_top == other.ras_top))
+            return false;
+        if (!(ras_tos == other.ras_tos))
+            return false;
+        if (!(fuse == other.fuse))
+            return false;
+        if (!(move == other.move))
+            return false;
         return true;
     }
 
@@ -309,24 +645,86 @@ struct de_out_t {
         pc = other.pc;
         imm_u = other.imm_u;
         tag = other.tag;
+        id = other.id;
+        predecode = other.predecode;
+        next_pc = other.next_pc;
+        ras_top = other.ras_top;
+        ras_tos = other.ras_tos;
+        fuse = other.fuse;
+        move = other.move;
         return *this;
     }
 
+    //
+    // Packed representation, fields from the lsb in declaration order.
+    //
+    template < int W >
+    inline void pack(ac_int < W, false > & bits, int & pos) const {
+        pack_field(bits, pos, regwrite);
+        pack_field(bits, pos, memtoreg);
+        pack_field(bits, pos, ld);
+        pack_field(bits, pos, st);
+        pack_field(bits, pos, alu_op);
+        pack_field(bits, pos, alu_src);
+        pack_field(bits, pos, rs1);
+        pack_field(bits, pos, rs2);
+        pack_field(bits, pos, dest_reg);
+        pack_field(bits, pos, pc);
+        pack_field(bits, pos, imm_u);
+        pack_field(bits, pos, tag);
+        pack_field(bits, pos, id);
+        // Execute only needs the kind of control transfer and the offset
+        pack_field(bits, pos, predecode.branch);
+        pack_field(bits, pos, predecode.jal);
+        pack_field(bits, pos, predecode.jalr);
+        pack_field(bits, pos, predecode.ret);
+        pack_field(bits, pos, predecode.imm);
+        pack_field(bits, pos, next_pc);
+        pack_field(bits, pos, ras_top);
+        pack_field(bits, pos, ras_tos);
+        pack_field(bits, pos, fuse);
+        pack_field(bits, pos, move);
+    }
+
+    template < int W >
+    inline void unpack(const ac_int < W, false > & bits, int & pos) {
+        unpack_field(bits, pos, regwrite);
+        unpack_field(bits, pos, memtoreg);
+        unpack_field(bits, pos, ld);
+        unpack_field(bits, pos, st);
+        unpack_field(bits, pos, alu_op);
+        unpack_field(bits, pos, alu_src);
+        unpack_field(bits, pos, rs1);
+        unpack_field(bits, pos, rs2);
+        unpack_field(bits, pos, dest_reg);
+        unpack_field(bits, pos, pc);
+        unpack_field(bits, pos, imm_u);
+        unpack_field(bits, pos, tag);
+        unpack_field(bits, pos, id);
+        predecode = predecode_t();
+        unpack_field(bits, pos, predecode.branch);
+        unpack_field(bits, pos, predecode.jal);
+        unpack_field(bits, pos, predecode.jalr);
+        unpack_field(bits, pos, predecode.ret);
+        unpack_field(bits, pos, predecode.imm);
+        unpack_field(bits, pos, next_pc);
+        unpack_field(bits, pos, ras_top);
+        unpack_field(bits, pos, ras_tos);
+        unpack_field(bits, pos, fuse);
+        unpack_field(bits, pos, move);
+    }
+
     template < unsigned int Size >
         void Marshall(Marshaller < Size > & m) {
-            m & regwrite;
-            m & memtoreg;
-            m & ld;
-            m & st;
-            m & alu_op;
-            m & alu_src;
-            m & rs1;
-            m & rs2;
-            m & dest_reg;
-            m & pc;
-            m & imm_u;
-            m & tag;
-
+            ac_int < width, false > bits = 0;
+            int pos = 0;
+            if (m.IsMarshalling()) {
+                pack(bits, pos);
+            }
+            m & bits;
+            if (!m.IsMarshalling()) {
+                unpack(bits, pos);
+            }
         }
 
     //
@@ -347,6 +745,13 @@ struct de_out_t {
         sc_trace(tf, object.pc, in_name + std::string(".pc"));
         sc_trace(tf, object.imm_u, in_name + std::string(".imm_u"));
         sc_trace(tf, object.tag, in_name + std::string(".tag"));
+        sc_trace(tf, object.id, in_name + std::string(".id"));
+        sc_trace(tf, object.predecode, in_name + std::string(".predecode"));
+        sc_trace(tf, object.next_pc, in_name + std::string(".next_pc"));
+        sc_trace(tf, object.ras_top, in_name + std::string(".ras_top"));
+        sc_trace(tf, object.ras_tos, in_name + std::string(".ras_tos"));
+        sc_trace(tf, object.fuse, in_name + std::string(".fuse"));
+        sc_trace(tf, object.move, in_name + std::string(".move"));
     }
 
     //
@@ -366,6 +771,13 @@ struct de_out_t {
         os << "," << object.pc;
         os << "," << object.imm_u;
         os << "," << object.tag;
+        os << "," << object.id;
+        os << "," << object.predecode;
+        os << "," << object.next_pc;
+        os << "," << object.ras_top;
+        os << "," << object.ras_tos;
+        os << "," << object.fuse;
+        os << "," << object.move;
         os << ")";
 
         return os;
@@ -376,6 +788,162 @@ struct de_out_t {
 #endif
 // ------------ END de_out_t
 
+// Issue
+// ------------ de_iss_t
+#ifndef de_iss_t_SC_WRAPPER_TYPE
+#define de_iss_t_SC_WRAPPER_TYPE 1
+
+struct de_iss_t {
+    //
+    // Member declarations.
+    //
+    de_out_t op; // Control word, the operands are read by the issue stage
+    ac_int < REG_ADDR, false > rs1_addr;
+    ac_int < REG_ADDR, false > rs2_addr;
+    bool rs1_const; // op.rs1 holds the constant of a fused LUI or AUIPC
+    bool bubble;
+    bool halt; // Jump to itself, end of the program
+    ac_int < TAG_WIDTH, false > tag; // Fetch epoch of the instruction
+
+    static
+    const int width = de_out_t::width + REG_ADDR + REG_ADDR + 1 + 1 + 1 + TAG_WIDTH;
+    //
+    // Default constructor.
+    //
+    de_iss_t() {
+        op = de_out_t();
+        rs1_addr = 0;
+        rs2_addr = 0;
+        rs1_const = false;
+        bubble = false;
+        halt = false;
+        tag = 0;
+    }
+
+    //
+    // Copy constructor.
+    //
+    de_iss_t(const de_iss_t & other) {
+        op = other.op;
+        rs1_addr = other.rs1_addr;
+        rs2_addr = other.rs2_addr;
+        rs1_const = other.rs1_const;
+        bubble = other.bubble;
+        halt = other.halt;
+        tag = other.tag;
+    }
+
+    //
+    // Comparison operator.
+    //
+    inline bool operator == (const de_iss_t & other) {
+        if (!(op == other.op))
+            return false;
+        if (!(rs1_addr == other.rs1_addr))
+            return false;
+        if (!(rs2_addr == other.rs2_addr))
+            return false;
+        if (!(rs1_const == other.rs1_const))
+            return false;
+        if (!(bubble == other.bubble))
+            return false;
+        if (!(halt == other.halt))
+            return false;
+        if (!(tag == other.tag))
+            return false;
+        return true;
+    }
+
+    //
+    // Assignment operator from de_iss_t.
+    //
+    inline de_iss_t & operator = (const de_iss_t & other) {
+        op = other.op;
+        rs1_addr = other.rs1_addr;
+        rs2_addr = other.rs2_addr;
+        rs1_const = other.rs1_const;
+        bubble = other.bubble;
+        halt = other.halt;
+        tag = other.tag;
+        return *this;
+    }
+
+    //
+    // Packed representation, fields from the lsb in declaration order.
+    //
+    template < int W >
+    inline void pack(ac_int < W, false > & bits, int & pos) const {
+        pack_field(bits, pos, op);
+        pack_field(bits, pos, rs1_addr);
+        pack_field(bits, pos, rs2_addr);
+        pack_field(bits, pos, rs1_const);
+        pack_field(bits, pos, bubble);
+        pack_field(bits, pos, halt);
+        pack_field(bits, pos, tag);
+    }
+
+    template < int W >
+    inline void unpack(const ac_int < W, false > & bits, int & pos) {
+        unpack_field(bits, pos, op);
+        unpack_field(bits, pos, rs1_addr);
+        unpack_field(bits, pos, rs2_addr);
+        unpack_field(bits, pos, rs1_const);
+        unpack_field(bits, pos, bubble);
+        unpack_field(bits, pos, halt);
+        unpack_field(bits, pos, tag);
+    }
+
+    template < unsigned int Size >
+        void Marshall(Marshaller < Size > & m) {
+            ac_int < width, false > bits = 0;
+            int pos = 0;
+            if (m.IsMarshalling()) {
+                pack(bits, pos);
+            }
+            m & bits;
+            if (!m.IsMarshalling()) {
+                unpack(bits, pos);
+            }
+        }
+
+    //
+    // sc_trace function.
+    //
+    inline friend void sc_trace(sc_trace_file * tf,
+        const de_iss_t & object,
+            const std::string & in_name) {
+        sc_trace(tf, object.op, in_name + std::string(".op"));
+        sc_trace(tf, object.rs1_addr, in_name + std::string(".rs1_addr"));
+        sc_trace(tf, object.rs2_addr, in_name + std::string(".rs2_addr"));
+        sc_trace(tf, object.rs1_const, in_name + std::string(".rs1_const"));
+        sc_trace(tf, object.bubble, in_name + std::string(".bubble"));
+        sc_trace(tf, object.halt, in_name + std::string(".halt"));
+        sc_trace(tf, object.tag, in_name + std::string(".tag"));
+    }
+
+    //
+    // stream operator.
+    //
+    inline friend ostream & operator << (ostream & os,
+        const de_iss_t & object) {
+        os << "(";
+        os << object.op;
+        os << "," << object.rs1_addr;
+        os << "," << object.rs2_addr;
+        os << "," << object.rs1_const;
+        os << "," << object.bubble;
+        os << "," << object.halt;
+        os << "," << object.tag;
+        os << ")";
+
+        return os;
+    }
+
+};
+
+#endif
+// ------------ END de_iss_t
+
 // Execute
 // ------------ exe_out_t
 #ifndef exe_out_t_SC_WRAPPER_TYPE
@@ -386,17 +954,17 @@ struct exe_out_t // TODO: fix all sizes
     //
     // Member declarations.
     //
-    sc_uint < 3 > ld;
-    sc_uint < 2 > st;
-    sc_uint < 1 > memtoreg;
-    sc_uint < 1 > regwrite;
-    sc_uint < XLEN > alu_res;
-    sc_int < DATA_SIZE > mem_datain;
-    sc_uint < REG_ADDR > dest_reg;
-    sc_uint < TAG_WIDTH > tag;
-    sc_uint < PC_LEN > pc;
+    ac_int < 3, false > ld;
+    ac_int < 2, false > st;
+    ac_int < 1, false > memtoreg;
+    ac_int < 1, false > regwrite;
+    ac_int < XLEN, false > alu_res;
+    ac_int < DATA_SIZE, true > mem_datain;
+    ac_int < REG_ADDR, false > dest_reg;
+    ac_int < TAG_WIDTH, false > tag;
+    ac_int < ID_WIDTH, false > id; // Issue slot of the instruction
 
-    static const int width = 3 + 2 + 1 + 1 + XLEN + DATA_SIZE + REG_ADDR + TAG_WIDTH + PC_LEN;
+    static const int width = 3 + 2 + 1 + 1 + DATA_SIZE + REG_ADDR + TAG_WIDTH + XLEN + ID_WIDTH;
 
     //
     // Default constructor.
@@ -410,7 +978,7 @@ struct exe_out_t // TODO: fix all sizes
         mem_datain = 0;
         dest_reg = 0;
         tag = 0;
-        pc = 0;
+        id = 0;
     }
 
     //
@@ -425,7 +993,7 @@ struct exe_out_t // TODO: fix all sizes
         mem_datain = other.mem_datain;
         dest_reg = other.dest_reg;
         tag = other.tag;
-        pc = other.pc;
+        id = other.id;
     }
 
     //
@@ -448,7 +1016,7 @@ struct exe_out_t // TODO: fix all sizes
             return false;
         if (!(tag == other.tag))
             return false;
-        if (!(pc == other.pc))
+        if (!(id == other.id))
             return false;
         return true;
     }
@@ -465,22 +1033,50 @@ struct exe_out_t // TODO: fix all sizes
         mem_datain = other.mem_datain;
         dest_reg = other.dest_reg;
         tag = other.tag;
-        pc = other.pc;
+        id = other.id;
         return *this;
     }
 
+    //
+    // Packed representation, fields from the lsb in declaration order.
+    //
+    template < int W >
+    inline void pack(ac_int < W, false > & bits, int & pos) const {
+        pack_field(bits, pos, ld);
+        pack_field(bits, pos, st);
+        pack_field(bits, pos, memtoreg);
+        pack_field(bits, pos, regwrite);
+        pack_field(bits, pos, alu_res);
+        pack_field(bits, pos, mem_datain);
+        pack_field(bits, pos, dest_reg);
+        pack_field(bits, pos, tag);
+        pack_field(bits, pos, id);
+    }
+
+    template < int W >
+    inline void unpack(const ac_int < W, false > & bits, int & pos) {
+        unpack_field(bits, pos, ld);
+        unpack_field(bits, pos, st);
+        unpack_field(bits, pos, memtoreg);
+        unpack_field(bits, pos, regwrite);
+        unpack_field(bits, pos, alu_res);
+        unpack_field(bits, pos, mem_datain);
+        unpack_field(bits, pos, dest_reg);
+        unpack_field(bits, pos, tag);
+        unpack_field(bits, pos, id);
+    }
+
     template < unsigned int Size >
         void Marshall(Marshaller < Size > & m) {
-            m & ld;
-            m & st;
-            m & memtoreg;
-            m & regwrite;
-            m & alu_res;
-            m & mem_datain;
-            m & dest_reg;
-            m & tag;
-            m & pc;
-
+            ac_int < width, false > bits = 0;
+            int pos = 0;
+            if (m.IsMarshalling()) {
+                pack(bits, pos);
+            }
+            m & bits;
+            if (!m.IsMarshalling()) {
+                unpack(bits, pos);
+            }
         }
 
     //
@@ -495,7 +1091,7 @@ struct exe_out_t // TODO: fix all sizes
         sc_trace(tf, object.mem_datain, in_name + std::string(".mem_datain"));
         sc_trace(tf, object.dest_reg, in_name + std::string(".dest_reg"));
         sc_trace(tf, object.tag, in_name + std::string(".tag"));
-        sc_trace(tf, object.pc, in_name + std::string(".pc"));
+        sc_trace(tf, object.id, in_name + std::string(".id"));
     }
 
     //
@@ -511,7 +1107,7 @@ struct exe_out_t // TODO: fix all sizes
         os << "," << object.mem_datain;
         os << "," << object.dest_reg;
         os << "," << object.tag;
-        os << "," << object.pc;
+        os << "," << object.id;
         os << ")";
 
         return os;
@@ -531,13 +1127,13 @@ struct mem_out_t {
     //
     // Member declarations.
     //
-    sc_uint < 1 > regwrite;
-    sc_uint < REG_ADDR > regfile_address;
-    sc_int < XLEN > regfile_data;
-    sc_uint < TAG_WIDTH > tag;
-    sc_uint < PC_LEN > pc;
+    ac_int < 1, false > regwrite;
+    ac_int < REG_ADDR, false > regfile_address;
+    ac_int < XLEN, true > regfile_data;
+    ac_int < TAG_WIDTH, false > tag;
+    ac_int < ID_WIDTH, false > id;
 
-    static const int width = 1 + REG_ADDR + XLEN + TAG_WIDTH + PC_LEN;
+    static const int width = 1 + REG_ADDR + XLEN + TAG_WIDTH + ID_WIDTH;
     //
     // Default constructor.
     //
@@ -546,7 +1142,7 @@ struct mem_out_t {
         regfile_address = 0;
         regfile_data = 0;
         tag = 0;
-        pc = 0;
+        id = 0;
     }
 
     //
@@ -557,7 +1153,7 @@ struct mem_out_t {
         regfile_address = other.regfile_address;
         regfile_data = other.regfile_data;
         tag = other.tag;
-        pc = other.pc;
+        id = other.id;
     }
 
     //
@@ -572,7 +1168,7 @@ struct mem_out_t {
             return false;
         if (!(tag == other.tag))
             return false;
-        if (!(pc == other.pc))
+        if (!(id == other.id))
             return false;
         return true;
     }
@@ -585,17 +1181,42 @@ struct mem_out_t {
         regfile_address = other.regfile_address;
         regfile_data = other.regfile_data;
         tag = other.tag;
-        pc = other.pc;
+        id = other.id;
         return *this;
     }
 
+    //
+    // Packed representation, fields from the lsb in declaration order.
+    //
+    template < int W >
+    inline void pack(ac_int < W, false > & bits, int & pos) const {
+        pack_field(bits, pos, regwrite);
+        pack_field(bits, pos, regfile_address);
+        pack_field(bits, pos, regfile_data);
+        pack_field(bits, pos, tag);
+        pack_field(bits, pos, id);
+    }
+
+    template < int W >
+    inline void unpack(const ac_int < W, false > & bits, int & pos) {
+        unpack_field(bits, pos, regwrite);
+        unpack_field(bits, pos, regfile_address);
+        unpack_field(bits, pos, regfile_data);
+        unpack_field(bits, pos, tag);
+        unpack_field(bits, pos, id);
+    }
+
     template < unsigned int Size >
         void Marshall(Marshaller < Size > & m) {
-            m & regwrite;
-            m & regfile_address;
-            m & regfile_data;
-            m & tag;
-            m & pc;
+            ac_int < width, false > bits = 0;
+            int pos = 0;
+            if (m.IsMarshalling()) {
+                pack(bits, pos);
+            }
+            m & bits;
+            if (!m.IsMarshalling()) {
+                unpack(bits, pos);
+            }
         }
 
     //
@@ -606,7 +1227,7 @@ struct mem_out_t {
         sc_trace(tf, object.regfile_address, in_name + std::string(".regfile_address"));
         sc_trace(tf, object.regfile_data, in_name + std::string(".regfile_data"));
         sc_trace(tf, object.tag, in_name + std::string(".tag"));
-        sc_trace(tf, object.pc, in_name + std::string(".pc"));
+        sc_trace(tf, object.id, in_name + std::string(".id"));
     }
 
     //
@@ -618,7 +1239,7 @@ struct mem_out_t {
         os << "," << object.regfile_address;
         os << "," << object.regfile_data;
         os << "," << object.tag;
-        os << "," << object.pc;
+        os << "," << object.id;
         os << ")";
         return os;
     }
@@ -636,14 +1257,15 @@ struct reg_forward_t {
     //
     // Member declarations.
     //
-    sc_int < XLEN > regfile_data;
+    ac_int < XLEN, true > regfile_data;
     bool ldst;
     bool sync_fewb;
-    sc_uint < TAG_WIDTH > tag;
-    sc_uint < PC_LEN > pc;
+    ac_int < TAG_WIDTH, false > tag; // Scoreboard tag of the producer
+    bool redirect; // Execute redirected the fetch, epoch holds the new one
+    ac_int < TAG_WIDTH, false > epoch;
 
     static
-    const int width = XLEN + 1 + 1 + TAG_WIDTH + PC_LEN;
+    const int width = XLEN + 1 + 1 + TAG_WIDTH + 1 + TAG_WIDTH;
     //
     // Default constructor.
     //
@@ -652,7 +1274,8 @@ struct reg_forward_t {
         ldst = false;
         sync_fewb = false;
         tag = 0;
-        pc = 0;
+        redirect = false;
+        epoch = 0;
     }
 
     //
@@ -663,7 +1286,8 @@ struct reg_forward_t {
         ldst = other.ldst;
         sync_fewb = other.sync_fewb;
         tag = other.tag;
-        pc = other.pc;
+        redirect = other.redirect;
+        epoch = other.epoch;
     }
 
     //
@@ -678,7 +1302,9 @@ struct reg_forward_t {
             return false;
         if (!(tag == other.tag))
             return false;
-        if (!(pc == other.pc))
+        if (!(redirect == other.redirect))
+            return false;
+        if (!(epoch == other.epoch))
             return false;
         return true;
     }
@@ -691,17 +1317,45 @@ struct reg_forward_t {
         ldst = other.ldst;
         sync_fewb = other.sync_fewb;
         tag = other.tag;
-        pc = other.pc;
+        redirect = other.redirect;
+        epoch = other.epoch;
         return *this;
     }
 
+    //
+    // Packed representation, fields from the lsb in declaration order.
+    //
+    template < int W >
+    inline void pack(ac_int < W, false > & bits, int & pos) const {
+        pack_field(bits, pos, regfile_data);
+        pack_field(bits, pos, ldst);
+        pack_field(bits, pos, sync_fewb);
+        pack_field(bits, pos, tag);
+        pack_field(bits, pos, redirect);
+        pack_field(bits, pos, epoch);
+    }
+
+    template < int W >
+    inline void unpack(const ac_int < W, false > & bits, int & pos) {
+        unpack_field(bits, pos, regfile_data);
+        unpack_field(bits, pos, ldst);
+        unpack_field(bits, pos, sync_fewb);
+        unpack_field(bits, pos, tag);
+        unpack_field(bits, pos, redirect);
+        unpack_field(bits, pos, epoch);
+    }
+
     template < unsigned int Size >
         void Marshall(Marshaller < Size > & m) {
-            m & regfile_data;
-            m & ldst;
-            m & sync_fewb;
-            m & tag;
-            m & pc;
+            ac_int < width, false > bits = 0;
+            int pos = 0;
+            if (m.IsMarshalling()) {
+                pack(bits, pos);
+            }
+            m & bits;
+            if (!m.IsMarshalling()) {
+                unpack(bits, pos);
+            }
         }
 
     //
@@ -714,7 +1368,8 @@ struct reg_forward_t {
         sc_trace(tf, object.ldst, in_name + std::string(".ldst"));
         sc_trace(tf, object.sync_fewb, in_name + std::string(".sync_fewb"));
         sc_trace(tf, object.tag, in_name + std::string(".tag"));
-        sc_trace(tf, object.pc, in_name + std::string(".pc"));
+        sc_trace(tf, object.redirect, in_name + std::string(".redirect"));
+        sc_trace(tf, object.epoch, in_name + std::string(".epoch"));
     }
 
     //
@@ -727,8 +1382,9 @@ struct reg_forward_t {
         if (object.ldst)
             os << "," << " mem";
         os << "," << object.tag;
+        os << "," << object.redirect;
+        os << "," << object.epoch;
         os << "," << object.sync_fewb;
-        os << "," << object.pc;
         os << ")";
         return os;
     }
@@ -747,7 +1403,7 @@ struct imem_in_t {
     //
     // Member declarations.
     //
-    sc_uint < XLEN > instr_addr;
+    ac_int < XLEN, false > instr_addr;
 
     static const int width = XLEN;
     //
@@ -815,7 +1471,7 @@ struct imem_out_t {
     //
     // Member declarations.
     //
-    sc_uint < ICACHE_LINE > instr_data;
+    ac_int < ICACHE_LINE, false > instr_data;
 
     static const int width = ICACHE_LINE;
     //
@@ -884,9 +1540,9 @@ struct dmem_in_t {
     //
     // Member declarations.
     //
-    sc_uint < XLEN > data_addr;
-    sc_uint < XLEN > write_addr;
-    sc_uint < DCACHE_LINE > data_in;
+    ac_int < XLEN, false > data_addr;
+    ac_int < XLEN, false > write_addr;
+    ac_int < DCACHE_LINE, false > data_in;
     bool read_en;
     bool write_en;
 
@@ -990,7 +1646,7 @@ struct dmem_out_t {
     //
     // Member declarations.
     //
-    sc_uint < DCACHE_LINE > data_out;
+    ac_int < DCACHE_LINE, false > data_out;
 
     static const int width = DCACHE_LINE;
     //
@@ -1060,14 +1716,17 @@ struct fe_in_t {
     //
     bool freeze;
     bool redirect;
-    sc_uint < PC_LEN > address;
+    ac_int < PC_LEN, false > address;
     bool btb_update;
-    bool ras_update;
+    ac_int < RAS_POINTER_SIZE, false > ras_top; // RAS checkpoint taken at fetch
+    ac_int < PC_LEN, false > ras_tos;
+    bool ind_update; // Resolved target of a JALR that is not a return
     bool branch_taken;
-    sc_uint < PC_LEN > pc;
-    sc_uint < PC_LEN > bta;
+    ac_int < PC_LEN, false > pc;
+    ac_int < PC_LEN, false > bta;
+    ac_int < TAG_WIDTH, false > tag; // Epoch of the fetch after a redirect
 
-    static const int width = 2 + PC_LEN + 3 + PC_LEN + PC_LEN;
+    static const int width = 2 + PC_LEN + 3 + RAS_POINTER_SIZE + PC_LEN + PC_LEN + PC_LEN + TAG_WIDTH;
     //
     // Default constructor.
     //
@@ -1076,10 +1735,13 @@ struct fe_in_t {
         redirect = false;
         address = 0;
         btb_update = false;
-        ras_update = false;
+        ras_top = 0;
+        ras_tos = 0;
+        ind_update = false;
         branch_taken = false; 
         pc = 0;
         bta = 0;
+        tag = 0;
     }
 
     //
@@ -1090,10 +1752,13 @@ struct fe_in_t {
         redirect = other.redirect;
         address = other.address;
         btb_update = other.btb_update;
-        ras_update = other.ras_update;
+        ras_top = other.ras_top;
+        ras_tos = other.ras_tos;
+        ind_update = other.ind_update;
         branch_taken = other.branch_taken;
         pc = other.pc;
         bta = other.bta;
+        tag = other.tag;
     }
 
     //
@@ -1108,7 +1773,11 @@ struct fe_in_t {
             return false;
         if (!(btb_update == other.btb_update))
             return false;
-        if (!(ras_update == other.ras_update))
+        if (!(ras_top == other.ras_top))
+            return false;
+        if (!(ras_tos == other.ras_tos))
+            return false;
+        if (!(ind_update == other.ind_update))
             return false;
         if (!(branch_taken == other.branch_taken))
             return false;   
@@ -1116,6 +1785,8 @@ struct fe_in_t {
             return false;
         if (!(bta == other.bta))
             return false;
+        if (!(tag == other.tag))
+            return false;
         return true;
     }
 
@@ -1127,10 +1798,13 @@ struct fe_in_t {
         redirect = other.redirect;
         address = other.address;
         btb_update = other.btb_update;
-        ras_update = other.ras_update;
+        ras_top = other.ras_top;
+        ras_tos = other.ras_tos;
+        ind_update = other.ind_update;
         branch_taken = other.branch_taken;
         pc = other.pc;
         bta = other.bta;
+        tag = other.tag;
 
         return *this;
     }
@@ -1141,10 +1815,13 @@ struct fe_in_t {
             m & redirect;
             m & address;
             m & btb_update;
-            m & ras_update;
+            m & ras_top;
+            m & ras_tos;
+            m & ind_update;
             m & branch_taken;
             m & pc;
             m & bta;
+            m & tag;
         }
 
     //
@@ -1155,10 +1832,13 @@ struct fe_in_t {
         sc_trace(tf, object.redirect, in_name + std::string(".redirect"));
         sc_trace(tf, object.address, in_name + std::string(".address"));
         sc_trace(tf, object.btb_update, in_name + std::string(".btb_update"));
-        sc_trace(tf, object.ras_update, in_name + std::string(".ras_update"));
+        sc_trace(tf, object.ras_top, in_name + std::string(".ras_top"));
+        sc_trace(tf, object.ras_tos, in_name + std::string(".ras_tos"));
+        sc_trace(tf, object.ind_update, in_name + std::string(".ind_update"));
         sc_trace(tf, object.branch_taken, in_name + std::string(".branch_taken"));
         sc_trace(tf, object.pc, in_name + std::string(".pc"));
         sc_trace(tf, object.bta, in_name + std::string(".bta"));
+        sc_trace(tf, object.tag, in_name + std::string(".tag"));
     }
 
     //
@@ -1171,10 +1851,13 @@ struct fe_in_t {
         os << object.redirect;
         os << object.address;
         os << object.btb_update;
-        os << object.ras_update;
+        os << object.ras_top;
+        os << object.ras_tos;
+        os << object.ind_update;
         os << object.branch_taken;
         os << object.pc;
         os << object.bta;
+        os << object.tag;
         os << ")";
         return os;
     }
@@ -1190,9 +1873,10 @@ struct icache_data_t {
     //
     // Member declarations.
     //
-    sc_uint < ICACHE_LINE > data;
+    ac_int < ICACHE_LINE, false > data;
+    predecode_t predecode[ICACHE_LINE_WORDS]; // Computed on refill, one per instruction of the line
 
-    static const int width = ICACHE_LINE;
+    static const int width = ICACHE_LINE + ICACHE_LINE_WORDS * predecode_t::width;
     //
     // Default constructor.
     //
@@ -1205,6 +1889,8 @@ struct icache_data_t {
     //
     icache_data_t(const icache_data_t &other) {
         data = other.data;
+        for (int i = 0; i < ICACHE_LINE_WORDS; i++)
+            predecode[i] = other.predecode[i];
     }
 
     //
@@ -1213,6 +1899,9 @@ struct icache_data_t {
     inline bool operator == (const icache_data_t &other) {
         if (!(data == other.data))
             return false;
+        for (int i = 0; i < ICACHE_LINE_WORDS; i++)
+            if (!(predecode[i] == other.predecode[i]))
+                return false;
         return true;
     }
 
@@ -1221,6 +1910,8 @@ struct icache_data_t {
     //
     inline icache_data_t & operator = (const icache_data_t &other) {
         data = other.data;
+        for (int i = 0; i < ICACHE_LINE_WORDS; i++)
+            predecode[i] = other.predecode[i];
 
         return *this;
     }
@@ -1228,6 +1919,8 @@ struct icache_data_t {
     template < unsigned int Size >
         void Marshall(Marshaller < Size > & m) {
             m & data;
+            for (int i = 0; i < ICACHE_LINE_WORDS; i++)
+                m & predecode[i];
         }
 
     //
@@ -1235,6 +1928,8 @@ struct icache_data_t {
     //
     inline friend void sc_trace(sc_trace_file * tf, const icache_data_t & object, const std::string & in_name) {
         sc_trace(tf, object.data, in_name + std::string(".data"));
+        for (int i = 0; i < ICACHE_LINE_WORDS; i++)
+            sc_trace(tf, object.predecode[i], in_name + std::string(".predecode"));
     }
 
     //
@@ -1244,6 +1939,8 @@ struct icache_data_t {
         const icache_data_t & object) {
         os << "(";
         os << object.data;
+        for (int i = 0; i < ICACHE_LINE_WORDS; i++)
+            os << object.predecode[i];
         os << ")";
         return os;
     }
@@ -1258,7 +1955,7 @@ struct icache_tag_t {
     //
     // Member declarations.
     //
-    sc_uint < ICACHE_TAG_WIDTH > tag;
+    ac_int < ICACHE_TAG_WIDTH, false > tag;
     bool valid;
 
     static const int width = ICACHE_TAG_WIDTH + 2;
@@ -1335,10 +2032,11 @@ struct icache_out_t {
     //
     // Member declarations.
     //
-    sc_uint < ICACHE_LINE > data;
+    ac_int < ICACHE_LINE, false > data;
+    predecode_t predecode[ICACHE_LINE_WORDS]; // Pre-decoded bits of the line
     bool hit;
 
-    static const int width = ICACHE_LINE + 1;
+    static const int width = ICACHE_LINE + ICACHE_LINE_WORDS * predecode_t::width + 1;
     //
     // Default constructor.
     //
@@ -1352,6 +2050,8 @@ struct icache_out_t {
     //
     icache_out_t(const icache_out_t &other) {
         data = other.data;
+        for (int i = 0; i < ICACHE_LINE_WORDS; i++)
+            predecode[i] = other.predecode[i];
         hit = other.hit;
     }
 
@@ -1361,6 +2061,9 @@ struct icache_out_t {
     inline bool operator == (const icache_out_t &other) {
         if (!(data == other.data))
             return false;
+        for (int i = 0; i < ICACHE_LINE_WORDS; i++)
+            if (!(predecode[i] == other.predecode[i]))
+                return false;
         if (!(hit == other.hit))
             return false;
         return true;
@@ -1371,6 +2074,8 @@ struct icache_out_t {
     //
     inline icache_out_t & operator = (const icache_out_t &other) {
         data = other.data;
+        for (int i = 0; i < ICACHE_LINE_WORDS; i++)
+            predecode[i] = other.predecode[i];
         hit = other.hit;
 
         return *this;
@@ -1379,6 +2084,8 @@ struct icache_out_t {
     template < unsigned int Size >
         void Marshall(Marshaller < Size > & m) {
             m & data;
+            for (int i = 0; i < ICACHE_LINE_WORDS; i++)
+                m & predecode[i];
             m & hit;
         }
 
@@ -1387,6 +2094,8 @@ struct icache_out_t {
     //
     inline friend void sc_trace(sc_trace_file * tf, const icache_out_t & object, const std::string & in_name) {
         sc_trace(tf, object.data, in_name + std::string(".data"));
+        for (int i = 0; i < ICACHE_LINE_WORDS; i++)
+            sc_trace(tf, object.predecode[i], in_name + std::string(".predecode"));
         sc_trace(tf, object.hit, in_name + std::string(".hit"));
     }
 
@@ -1397,6 +2106,8 @@ struct icache_out_t {
         const icache_out_t & object) {
         os << "(";
         os << object.data;
+        for (int i = 0; i < ICACHE_LINE_WORDS; i++)
+            os << object.predecode[i];
         os << object.hit;
         os << ")";
         return os;
@@ -1413,7 +2124,7 @@ struct dcache_data_t {
     //
     // Member declarations.
     //
-    sc_uint < DCACHE_LINE > data;
+    ac_int < DCACHE_LINE, false > data;
 
     static const int width = DCACHE_LINE;
     //
@@ -1481,7 +2192,7 @@ struct dcache_tag_t {
     //
     // Member declarations.
     //
-    sc_uint < DCACHE_TAG_WIDTH > tag;
+    ac_int < DCACHE_TAG_WIDTH, false > tag;
     bool valid;
     bool dirty;
 
@@ -1567,7 +2278,7 @@ struct dcache_out_t {
     //
     // Member declarations.
     //
-    sc_uint < DCACHE_LINE > data;
+    ac_int < DCACHE_LINE, false > data;
     bool hit;
 
     static const int width = DCACHE_LINE + 1;
@@ -1645,18 +2356,18 @@ struct btb_data_t {
     //
     // Member declarations.
     //
-    sc_uint < BTB_TAG_WIDTH > tag;
-    sc_uint < PC_LEN > bta;
-    sc_uint < BTB_PREDICTION_BITS_WIDTH > prediction_data;
+    ac_int < BTB_TAG_WIDTH, false > tag;
+    ac_int < PC_LEN, false > bta;
+    bool valid;
 
-    static const int width = BTB_TAG_WIDTH + PC_LEN + BTB_PREDICTION_BITS_WIDTH;
+    static const int width = BTB_TAG_WIDTH + PC_LEN + 1;
     //
     // Default constructor.
     //
     btb_data_t() {
         tag = 0;
         bta = 0;
-        prediction_data = 0;
+        valid = false;
     }
 
     //
@@ -1665,7 +2376,7 @@ struct btb_data_t {
     btb_data_t(const btb_data_t &other) {
         tag = other.tag;
         bta = other.bta;
-        prediction_data = other.prediction_data;
+        valid = other.valid;
     }
 
     //
@@ -1676,7 +2387,7 @@ struct btb_data_t {
             return false;
         if (!(bta == other.bta))
             return false;
-        if (!(prediction_data == other.prediction_data))
+        if (!(valid == other.valid))
             return false;
         return true;
     }
@@ -1687,7 +2398,7 @@ struct btb_data_t {
     inline btb_data_t & operator = (const btb_data_t &other) {
         tag = other.tag;
         bta = other.bta;
-        prediction_data = other.prediction_data;
+        valid = other.valid;
 
         return *this;
     }
@@ -1696,7 +2407,7 @@ struct btb_data_t {
         void Marshall(Marshaller < Size > & m) {
             m & tag;
             m & bta;
-            m & prediction_data;
+            m & valid;
         }
 
     //
@@ -1705,7 +2416,7 @@ struct btb_data_t {
     inline friend void sc_trace(sc_trace_file * tf, const btb_data_t & object, const std::string & in_name) {
         sc_trace(tf, object.tag, in_name + std::string(".tag"));
         sc_trace(tf, object.bta, in_name + std::string(".bta"));
-        sc_trace(tf, object.prediction_data, in_name + std::string(".prediction_data"));
+        sc_trace(tf, object.valid, in_name + std::string(".valid"));
     }
 
     //
@@ -1716,7 +2427,7 @@ struct btb_data_t {
         os << "(";
         os << object.tag;
         os << object.bta;
-        os << object.prediction_data;
+        os << object.valid;
         os << ")";
         return os;
     }
@@ -1734,7 +2445,7 @@ struct btb_out_t {
     //
     bool btb_valid;
     bool ras_valid;
-    sc_uint < PC_LEN > bta;
+    ac_int < PC_LEN, false > bta;
 
     static const int width = 2 + PC_LEN;
     //
@@ -14,6 +14,11 @@
 
 		- Consists of only one thread
 
+		- Resolves the branches and jumps. When the next pc differs from the
+		  one predicted by the fetch stage, the fetch is redirected to the
+		  right path and a new epoch starts. Decode squashes the instructions
+		  of the older epochs.
+
 
 */
 
@@ -30,19 +35,20 @@
 #include "drim4hls_datatypes.h"
 #include "defines.h"
 #include "globals.h"
+#include "../../common/compare.h"
 
 #include <mc_connections.h>
 
 // Signed division quotient and remainder struct.
 struct div_res_t {
-    sc_int < XLEN > quotient;
-    sc_int < XLEN > remainder;
+    ac_int < XLEN, true > quotient;
+    ac_int < XLEN, true > remainder;
 };
 
 // Unsigned division quotient and remainder struct.
 struct u_div_res_t {
-    sc_uint < XLEN > quotient;
-    sc_uint < XLEN > remainder;
+    ac_int < XLEN, false > quotient;
+    ac_int < XLEN, false > remainder;
 };
 
 SC_MODULE(execute) {
@@ -53,14 +59,14 @@ SC_MODULE(execute) {
         //
         // Member declarations.
         //
-        sc_uint < 3 > ld;
-        sc_uint < 2 > st;
-        sc_uint < 1 > memtoreg;
-        sc_uint < 1 > regwrite;
-        sc_uint < XLEN > alu_res;
-        sc_uint < DATA_SIZE > mem_datain;
-        sc_uint < REG_ADDR > dest_reg;
-        sc_uint < TAG_WIDTH > tag;
+        ac_int < 3, false > ld;
+        ac_int < 2, false > st;
+        ac_int < 1, false > memtoreg;
+        ac_int < 1, false > regwrite;
+        ac_int < XLEN, false > alu_res;
+        ac_int < DATA_SIZE, false > mem_datain;
+        ac_int < REG_ADDR, false > dest_reg;
+        ac_int < TAG_WIDTH, false > tag;
         std::string alu_src;
         std::string alu_op;
 
@@ -76,6 +82,8 @@ SC_MODULE(execute) {
     Connections::Out < exe_out_t > CCS_INIT_S1(dout);
     // Forward
     Connections::Out < reg_forward_t > CCS_INIT_S1(fwd_exe);
+    // Resolved branches and jumps
+    Connections::Out < fe_in_t > CCS_INIT_S1(fetch_dout);
     
     // Member variables
     de_out_t data_in;
@@ -83,32 +91,35 @@ SC_MODULE(execute) {
     exe_out_t output;
     dmem_in_t dmem_din;
     reg_forward_t forward;
+    fe_in_t fetch_out;
+
+    ac_int < TAG_WIDTH, false > epoch; // Incremented on every redirect of the fetch
 
-    sc_uint < XLEN > csr[CSR_NUM]; // Control and status registers.
+    ac_int < XLEN, false > csr[CSR_NUM]; // Control and status registers.
 
     bool freeze;
     
     // Constructor
-    SC_CTOR(execute): din("din"), dout("dout"), fwd_exe("fwd_exe"), clk("clk"), rst("rst") {
+    SC_CTOR(execute): din("din"), dout("dout"), fwd_exe("fwd_exe"), fetch_dout("fetch_dout"), clk("clk"), rst("rst") {
         SC_THREAD(execute_th);
         sensitive << clk.pos();
         async_reset_signal_is(rst, false);
     }
 
-    u_div_res_t udiv_func(sc_uint < XLEN > num, sc_uint < XLEN > den) {
-        sc_uint < XLEN > rem;
-        sc_uint < XLEN > quotient;
+    u_div_res_t udiv_func(ac_int < XLEN, false > num, ac_int < XLEN, false > den) {
+        ac_int < XLEN, false > rem;
+        ac_int < XLEN, false > quotient;
         u_div_res_t u_div_res;
 
         rem = 0;
         quotient = 0;
 
         DIVIDE_LOOP:
-            for (sc_int < 6 > i = 31; i >= 0; i--) {
+            for (ac_int < 6, true > i = 31; i >= 0; i--) {
                 // Break EXE stage protocol for DSE
 
-                const sc_uint < XLEN > mask = BIT(i);
-                const sc_uint < XLEN > lsb = (mask & num) >> i;
+                const ac_int < XLEN, false > mask = BIT(i);
+                const ac_int < XLEN, false > lsb = (mask & num) >> i;
 
                 rem = rem << 1;
                 rem = rem | lsb;
@@ -126,7 +137,7 @@ SC_MODULE(execute) {
         return u_div_res;
     }
 
-    div_res_t div_func(sc_int < XLEN > num, sc_int < XLEN > den) {
+    div_res_t div_func(ac_int < XLEN, true > num, ac_int < XLEN, true > den) {
         bool num_neg;
         bool den_neg;
         div_res_t div_res;
@@ -140,9 +151,9 @@ SC_MODULE(execute) {
         if (den_neg)
             den = -den;
 
-        u_div_res = udiv_func((sc_uint < XLEN > ) num, (sc_uint < XLEN > ) den);
-        div_res.quotient = (sc_int < XLEN > ) u_div_res.quotient;
-        div_res.remainder = (sc_int < XLEN > ) u_div_res.remainder;
+        u_div_res = udiv_func((ac_int < XLEN, false > ) num, (ac_int < XLEN, false > ) den);
+        div_res.quotient = (ac_int < XLEN, true > ) u_div_res.quotient;
+        div_res.remainder = (ac_int < XLEN, true > ) u_div_res.remainder;
 
         if (num_neg ^ den_neg)
             div_res.quotient = -div_res.quotient;
@@ -157,8 +168,10 @@ SC_MODULE(execute) {
             din.Reset();
             dout.Reset();
             fwd_exe.Reset();
+            fetch_dout.Reset();
 			
             output.tag = 0;
+            epoch = 0;
 
             csr[MISA_I] = 0x40001101; // RV32IMA
             csr[MARCHID_I] = 0x0; // Not implemented (should be assigned by RISC-V
@@ -185,7 +198,7 @@ SC_MODULE(execute) {
             output.dest_reg = input.dest_reg;
             output.mem_datain = input.rs2;
             output.tag = input.tag;
-            output.pc = input.pc;
+            output.id = input.id;
 			
             bool nop = false;
             if (input.regwrite[0] == 0 &&
@@ -197,7 +210,7 @@ SC_MODULE(execute) {
             #ifdef MUL64
             // 64-bit temporary multiplication result, for upper 32 bit multiplications (MULH, MULHU, MULHSU).
             //int64_t tmp_mul_res = 0;
-            sc_uint <64> tmp_mul_res = 0;
+            ac_int < 64, false > tmp_mul_res = 0;
             #endif
             #ifdef DIV
             // Temporary division results.
@@ -212,22 +225,21 @@ SC_MODULE(execute) {
             #endif
             #ifdef CSR_LOGIC
             // Temporary CSR index
-            sc_uint < CSR_IDX_LEN > csr_index = 0;
+            ac_int < CSR_IDX_LEN, false > csr_index = 0;
             #endif
 
             // Sign extend the immediate operand for I-type instructions.
-            sc_uint < XLEN > tmp_sigext_imm_i = 0;
+            ac_int < XLEN, false > tmp_sigext_imm_i = 0;
+            tmp_sigext_imm_i.set_slc(0, input.imm_u.slc<12>(8));
             if (input.imm_u[19] == 1) {
                 // Extend with 1s
-                tmp_sigext_imm_i = (sc_uint < 20 > (1048575), (sc_uint < 12 > ) input.imm_u.range(19, 8));
-            } else {
-                // Extend with 0s
-                tmp_sigext_imm_i = (sc_uint < 20 > (0), (sc_uint < 12 > ) input.imm_u.range(19, 8));
+                tmp_sigext_imm_i.set_slc(12, (ac_int < 20, false >) 1048575);
             }
             // Zero-fill the immediate operand for U-type instructions.
-            sc_uint < XLEN > tmp_zerofill_imm_u = ((sc_uint < 20 > ) input.imm_u.range(19, 0), sc_uint < 12 > (0));
+            ac_int < XLEN, false > tmp_zerofill_imm_u = 0;
+            tmp_zerofill_imm_u.set_slc(12, input.imm_u.slc<20>(0));
             // ALU 2nd operand multiplexing based on ALUSRC signal.
-            sc_uint < XLEN > tmp_rs2 = 0;
+            ac_int < XLEN, false > tmp_rs2 = 0;
 
             if (input.alu_src == ALUSRC_RS2) {
                 tmp_rs2 = input.rs2;
@@ -245,7 +257,9 @@ SC_MODULE(execute) {
 
             } else if (input.alu_src == ALUSRC_IMM_S) {
                 // reconstructs imm_s from imm_u and rd
-                sc_uint<12> imm_s = (sc_uint<7>(input.imm_u.range(19, 13)), input.dest_reg);
+                ac_int < 12, false > imm_s;
+                imm_s.set_slc(0, input.dest_reg);
+                imm_s.set_slc(5, input.imm_u.slc<7>(13));
                 tmp_rs2 = sign_extend_imm_s(imm_s);
 
                 #ifndef __SYNTHESIS__
@@ -264,7 +278,7 @@ SC_MODULE(execute) {
             // ALU body
             switch (input.alu_op) {
             case ALUOP_ADD: // ADD, ADDI, SB, SH, SW, LB, LH, LW, LBU, LHU.
-                output.alu_res = (sc_uint<32>) input.rs1.to_int() + tmp_rs2.to_int();
+                output.alu_res = (ac_int < 32, false >) input.rs1.to_int() + tmp_rs2.to_int();
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_ADD";
@@ -272,7 +286,7 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_SLT: // SLT, SLTI
-                if ((sc_int<32>) input.rs1 < (sc_int<32>) tmp_rs2)
+                if ((ac_int < 32, true >) input.rs1 < (ac_int < 32, true >) tmp_rs2)
                     output.alu_res = 1;
                 else
                     output.alu_res = 0;
@@ -283,7 +297,7 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_SLTU: // SLTU, SLTIU
-                if ((sc_uint<32>) input.rs1  < (sc_uint<32>) tmp_rs2)
+                if ((ac_int < 32, false >) input.rs1  < (ac_int < 32, false >) tmp_rs2)
                     output.alu_res = 1;
                 else
                     output.alu_res = 0;
@@ -318,7 +332,7 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_SLL: // SLL
-                output.alu_res = (sc_uint < XLEN >) input.rs1 << (sc_uint < SHAMT >) tmp_rs2.range(4, 0);
+                output.alu_res = (ac_int < XLEN, false >) input.rs1 << (ac_int < SHAMT, false >) tmp_rs2.slc<5>(0);
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_SLL";
@@ -326,7 +340,7 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_SRL: // SRL
-                output.alu_res = (sc_uint < XLEN >) input.rs1 >> (sc_uint < SHAMT >) tmp_rs2.range(4, 0);
+                output.alu_res = (ac_int < XLEN, false >) input.rs1 >> (ac_int < SHAMT, false >) tmp_rs2.slc<5>(0);
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_SRL";
@@ -334,8 +348,8 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_SRA: // SRA
-                // >> is arith right sh. for sc_int operand
-                output.alu_res = (sc_int < XLEN >) input.rs1 >> (sc_uint < SHAMT >) tmp_rs2.range(4, 0);
+                // >> is arith right sh. for signed ac_int operand
+                output.alu_res = (ac_int < XLEN, true >) input.rs1 >> (ac_int < SHAMT, false >) tmp_rs2.slc<5>(0);
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_SRA";
@@ -343,7 +357,7 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_SUB: // SUB
-                output.alu_res = (sc_uint < XLEN >) ((sc_int < XLEN >) input.rs1 - (sc_int < XLEN >) tmp_rs2);
+                output.alu_res = (ac_int < XLEN, false >) ((ac_int < XLEN, true >) input.rs1 - (ac_int < XLEN, true >) tmp_rs2);
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_SUB";
@@ -351,15 +365,23 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_SLLI: // SLLI
-                output.alu_res = (sc_uint < XLEN >) input.rs1 << (sc_uint < SHAMT >) tmp_rs2.range(24, 20);
+                output.alu_res = (ac_int < XLEN, false >) input.rs1 << (ac_int < SHAMT, false >) tmp_rs2.slc<5>(20);
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_SLLI";
                 #endif
 
+                break;
+            case ALUOP_SHADD: // Fused SLLI+ADD
+                output.alu_res = ((ac_int < XLEN, false >) input.rs1 << (ac_int < SHAMT, false >) input.imm_u.slc<5>(8)) + tmp_rs2;
+
+                #ifndef __SYNTHESIS__
+                debug_exe_out_t.alu_op = "ALUOP_SHADD";
+                #endif
+
                 break;
             case ALUOP_SRLI: // SRLI
-                output.alu_res = (sc_uint < XLEN >) input.rs1 >> (sc_uint < SHAMT >) tmp_rs2.range(24, 20);
+                output.alu_res = (ac_int < XLEN, false >) input.rs1 >> (ac_int < SHAMT, false >) tmp_rs2.slc<5>(20);
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_SRLI";
@@ -367,8 +389,8 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_SRAI: // SRAI
-                // >> is arith right sh. for sc_int operand
-                output.alu_res = (sc_int < XLEN >) input.rs1 >> (sc_uint < SHAMT >) tmp_rs2.range(24, 20);
+                // >> is arith right sh. for signed ac_int operand
+                output.alu_res = (ac_int < XLEN, true >) input.rs1 >> (ac_int < SHAMT, false >) tmp_rs2.slc<5>(20);
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_SRAI";
@@ -386,7 +408,7 @@ SC_MODULE(execute) {
                 break;
             case ALUOP_AUIPC: // AUIPC
                 // zerofill_imm_u + pc
-                output.alu_res = (sc_int < XLEN >) tmp_rs2 + (sc_int < XLEN >) input.pc;
+                output.alu_res = (ac_int < XLEN, true >) tmp_rs2 + (ac_int < XLEN, true >) input.pc;
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_AUIPC";
@@ -395,7 +417,7 @@ SC_MODULE(execute) {
                 break;
             case ALUOP_JAL: // JAL, JALR
                 // link register update
-                output.alu_res = (sc_int < XLEN >) input.pc + 4;
+                output.alu_res = (ac_int < XLEN, true >) input.pc + 4;
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_JAL";
@@ -404,7 +426,7 @@ SC_MODULE(execute) {
                 break;
                 #ifdef MUL32
             case ALUOP_MUL: // MUL: signed * signed, return lower 32 bits
-                output.alu_res = (sc_int < XLEN >) input.rs1 * (sc_int < XLEN >) tmp_rs2;
+                output.alu_res = (ac_int < XLEN, true >) input.rs1 * (ac_int < XLEN, true >) tmp_rs2;
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_MUL";
@@ -414,8 +436,8 @@ SC_MODULE(execute) {
                 #endif
                 #ifdef MUL64
             case ALUOP_MULH: // MULH: signed * signed, return upper 32 bits
-                tmp_mul_res = input.rs1.to_int() * tmp_rs2.to_int();
-                output.alu_res = sc_uint<XLEN*2>(sc_int<XLEN*2>(tmp_mul_res)).range((XLEN*2)-1, XLEN);
+                tmp_mul_res = (ac_int < XLEN, true >) input.rs1 * (ac_int < XLEN, true >) tmp_rs2;
+                output.alu_res = tmp_mul_res.slc<XLEN>(XLEN);
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_MULH";
@@ -423,8 +445,8 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_MULHSU: // MULHSU: signed * unsigned, return upper 32 bits
-                tmp_mul_res = input.rs1 * tmp_rs2.to_uint();
-                output.alu_res = sc_uint<XLEN*2>(sc_int<XLEN*2>(tmp_mul_res)).range((XLEN*2)-1, XLEN);
+                tmp_mul_res = (ac_int < XLEN, true >) input.rs1 * (ac_int < XLEN, false >) tmp_rs2;
+                output.alu_res = tmp_mul_res.slc<XLEN>(XLEN);
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_MULHSU";
@@ -432,8 +454,8 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_MULHU: // MULHU: unsigned * unsigned, return upper 32 bits
-                tmp_mul_res = input.rs1.to_int() * tmp_rs2.to_uint();
-                output.alu_res = sc_uint<XLEN*2>(sc_int<XLEN*2>(tmp_mul_res)).range((XLEN*2)-1, XLEN);
+                tmp_mul_res = (ac_int < XLEN, false >) input.rs1 * (ac_int < XLEN, false >) tmp_rs2;
+                output.alu_res = tmp_mul_res.slc<XLEN>(XLEN);
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_MULHU";
@@ -443,7 +465,7 @@ SC_MODULE(execute) {
                 #endif
                 #ifdef DIV
             case ALUOP_DIV: // DIV calls div_func
-                div_res = div_func((sc_int < XLEN >) input.rs1, (sc_int < XLEN >) tmp_rs2);
+                div_res = div_func((ac_int < XLEN, true >) input.rs1, (ac_int < XLEN, true >) tmp_rs2);
                 output.alu_res = div_res.quotient;
 
                 #ifndef __SYNTHESIS__
@@ -463,7 +485,7 @@ SC_MODULE(execute) {
                 #endif
                 #ifdef REM
             case ALUOP_REM: // REM calls div_func
-                div_res = div_func((sc_int < XLEN >) input.rs1, (sc_int < XLEN >) tmp_rs2);
+                div_res = div_func((ac_int < XLEN, true >) input.rs1, (ac_int < XLEN, true >) tmp_rs2);
                 output.alu_res = div_res.remainder;
 
                 #ifndef __SYNTHESIS__
@@ -486,9 +508,9 @@ SC_MODULE(execute) {
                 // This avoids having 12 more bits on the FEDEC-EXE Flex Channel.
                 // The same goes for imm_u[7:3] i.e. zimm for the 3 CSRxI instructions.
             case ALUOP_CSRRW: // CSRRW
-                csr_index = get_csr_index(input.imm_u.range(19, 8));
+                csr_index = get_csr_index(input.imm_u.slc<12>(8));
                 output.alu_res = csr[csr_index];
-                set_csr_value(csr_index, input.rs1.to_uint(), CSR_OP_WR, input.imm_u.range(19, 18).to_uint());
+                set_csr_value(csr_index, input.rs1.to_uint(), CSR_OP_WR, input.imm_u.slc<2>(18).to_uint());
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_CSRRW";
@@ -496,9 +518,9 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_CSRRS: // CSRRS
-                csr_index = get_csr_index(input.imm_u.range(19, 8));
+                csr_index = get_csr_index(input.imm_u.slc<12>(8));
                 output.alu_res = csr[csr_index];
-                set_csr_value(csr_index, input.rs1.to_uint(), CSR_OP_SET, input.imm_u.range(19, 18).to_uint());
+                set_csr_value(csr_index, input.rs1.to_uint(), CSR_OP_SET, input.imm_u.slc<2>(18).to_uint());
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_CSRRS";
@@ -506,9 +528,9 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_CSRRC: // CSRRC
-                csr_index = get_csr_index(input.imm_u.range(19, 8));
+                csr_index = get_csr_index(input.imm_u.slc<12>(8));
                 output.alu_res = csr[csr_index];
-                set_csr_value(csr_index, input.rs1.to_uint(), CSR_OP_CLR, input.imm_u.range(19, 18).to_uint());
+                set_csr_value(csr_index, input.rs1.to_uint(), CSR_OP_CLR, input.imm_u.slc<2>(18).to_uint());
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_CSRRC";
@@ -516,9 +538,9 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_CSRRWI: // CSRRWI
-                csr_index = get_csr_index(input.imm_u.range(19, 8));
+                csr_index = get_csr_index(input.imm_u.slc<12>(8));
                 output.alu_res = csr[csr_index];
-                set_csr_value(csr_index, input.imm_u.range(7, 3).to_uint(), CSR_OP_WR, input.imm_u.range(19, 18).to_uint());
+                set_csr_value(csr_index, input.imm_u.slc<5>(3).to_uint(), CSR_OP_WR, input.imm_u.slc<2>(18).to_uint());
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_CSRRWI";
@@ -526,9 +548,9 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_CSRRSI: // CSRRSI
-                csr_index = get_csr_index(input.imm_u.range(19, 8));
+                csr_index = get_csr_index(input.imm_u.slc<12>(8));
                 output.alu_res = csr[csr_index];
-                set_csr_value(csr_index, input.imm_u.range(7, 3).to_uint(), CSR_OP_SET, input.imm_u.range(19, 18).to_uint());
+                set_csr_value(csr_index, input.imm_u.slc<5>(3).to_uint(), CSR_OP_SET, input.imm_u.slc<2>(18).to_uint());
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_CSRRSI";
@@ -536,9 +558,9 @@ SC_MODULE(execute) {
 
                 break;
             case ALUOP_CSRRCI: // CSRRCI
-                csr_index = get_csr_index(input.imm_u.range(19, 8));
+                csr_index = get_csr_index(input.imm_u.slc<12>(8));
                 output.alu_res = csr[csr_index];
-                set_csr_value(csr_index, input.imm_u.range(7, 3).to_uint(), CSR_OP_CLR, input.imm_u.range(19, 18).to_uint());
+                set_csr_value(csr_index, input.imm_u.slc<5>(3).to_uint(), CSR_OP_CLR, input.imm_u.slc<2>(18).to_uint());
 
                 #ifndef __SYNTHESIS__
                 debug_exe_out_t.alu_op = "ALUOP_CSRRCI";
@@ -566,23 +588,69 @@ SC_MODULE(execute) {
                 forward.ldst = true;
             }
 
+            // Only the producers own a scoreboard tag
+            if (input.regwrite[0] == 0) {
+                forward.ldst = true;
+            }
+
+            // *** Branch and jump resolution.
+            // Branch and JAL offsets come pre-decoded from the I$, the target
+            // is not sent along with the instruction
+            bool taken = input.predecode.jal || input.predecode.jalr;
+            ac_int < PC_LEN, false > target = input.pc + sign_extend_jump(input.predecode.imm);
+            if (input.predecode.jalr) {
+                target = input.rs1 + tmp_sigext_imm_i;
+                target[0] = 0;
+            } else if (input.fuse == FUSE_CMP_BEQZ) { // Fused compare-and-branch
+                taken = (output.alu_res == 0);
+            } else if (input.fuse == FUSE_CMP_BNEZ) {
+                taken = (output.alu_res != 0);
+            } else if (input.predecode.branch) { // BEQ,BNE, BLT, BGE, BLTU, BGEU
+                taken = branch_taken(compare(input.rs1, input.rs2), input.imm_u.slc<3>(0));
+            }
+            ac_int < PC_LEN, false > next_pc = taken ? target : (ac_int < PC_LEN, false >)(input.pc + 4);
+            bool control = input.predecode.branch || input.predecode.jal || input.predecode.jalr;
+            // The next pc of every instruction is checked, a BTB alias may
+            // have predicted a non-branch as taken
+            bool redirect = (next_pc != input.next_pc);
+            if (redirect) {
+                epoch = epoch + 1;
+            }
+
+            fetch_out.redirect = redirect;
+            fetch_out.tag = epoch;
+            fetch_out.address = next_pc;
+            fetch_out.pc = input.pc;
+            fetch_out.bta = target;
+            fetch_out.branch_taken = input.predecode.branch && taken;
+            fetch_out.btb_update = input.predecode.branch;
+            fetch_out.ind_update = input.predecode.jalr && !input.predecode.ret;
+            fetch_out.ras_top = input.ras_top;
+            fetch_out.ras_tos = input.ras_tos;
+            // *** END of branch and jump resolution.
+
+            forward.redirect = redirect;
+            forward.epoch = epoch;
             if (!nop) {
                 forward.tag = output.tag;
                 forward.regfile_data = output.alu_res;
-                forward.pc = input.pc;
             }
 
             if (!nop)
-               csr[MINSTRET_I]++;
+               csr[MINSTRET_I] += (input.fuse != FUSE_NONE) ? 2 : 1;
 
             // Put
 			fwd_exe.Push(forward);
+            if (control || redirect) {
+                fetch_dout.Push(fetch_out);
+            }
             dout.Push(output);
             #ifndef __SYNTHESIS__
             DPRINT("@" << sc_time_stamp() << "\t" << name() << "\t" << "nop " << nop << endl);
             DPRINT("@" << sc_time_stamp() << "\t" << name() << "\t" << std::hex << "pc= " << input.pc << endl);
             DPRINT("@" << sc_time_stamp() << "\t" << name() << "\t" << "forward.regfile_data " << forward.regfile_data << endl);
             DPRINT("@" << sc_time_stamp() << "\t" << name() << "\t" << "forward.tag " << forward.tag << endl);
+            DPRINT("@" << sc_time_stamp() << "\t" << name() << "\t" << "forward.epoch " << forward.epoch << endl);
             DPRINT("@" << sc_time_stamp() << "\t" << name() << "\t" << "output.alu_op " << debug_exe_out_t.alu_op << endl);
             DPRINT("@" << sc_time_stamp() << "\t" << name() << "\t" << "output.alu_res " << output.alu_res << endl);
             DPRINT("@" << sc_time_stamp() << "\t" << name() << "\t" << "output.ld " << output.ld << endl);
@@ -599,31 +667,40 @@ SC_MODULE(execute) {
     /* Support functions */
 
     // Sign extend immS.
-    sc_uint < XLEN > sign_extend_imm_s(sc_uint < 12 > imm) {
-        sc_uint <XLEN> imm_ext = 0;
+    ac_int < XLEN, false > sign_extend_imm_s(ac_int < 12, false > imm) {
+        ac_int < XLEN, false > imm_ext = 0;
         if (imm[11] == 1) {
 			// Extend with 1s
-			imm_ext.range(11, 0) = imm;
-			imm_ext.range(31, 12) = (sc_uint < 20 >) 1048575;
+			imm_ext.set_slc(0, imm);
+			imm_ext.set_slc(12, (ac_int < 20, false >) 1048575);
             return imm_ext;
         }
         else { 
 			// Extend with 0s
-			imm_ext.range(11 , 0) = imm;
+			imm_ext.set_slc(0, imm);
             return imm_ext;
         }
     }
 
+    // Sign extend the pre-decoded branch or JAL offset.
+    ac_int < PC_LEN, false > sign_extend_jump(ac_int < PREDECODE_IMM_WIDTH, false > imm) {
+        ac_int < PC_LEN, false > ext_imm = imm;
+        if (imm[PREDECODE_IMM_WIDTH - 1] == 1) {
+            ext_imm.set_slc(PREDECODE_IMM_WIDTH, (ac_int < PC_LEN - PREDECODE_IMM_WIDTH, false >) 2047);
+        }
+        return ext_imm;
+    }
+
     #ifdef CSR_LOGIC
     // Zero extends the zimm immediate field of CSRRWI, CSRRSI, CSRRCI
-    sc_uint < XLEN > zero_ext_zimm(sc_uint < ZIMM_SIZE > zimm) {
-        sc_uint <XLEN> zimm_ext = 0;
-        zimm_ext.range(4, 0) = zimm;
+    ac_int < XLEN, false > zero_ext_zimm(ac_int < ZIMM_SIZE, false > zimm) {
+        ac_int < XLEN, false > zimm_ext = 0;
+        zimm_ext.set_slc(0, zimm);
         return zimm_ext;
     }
 
     // Return index given a csr address.
-    sc_uint < CSR_IDX_LEN > get_csr_index(sc_uint < CSR_ADDR > csr_addr) {
+    ac_int < CSR_IDX_LEN, false > get_csr_index(ac_int < CSR_ADDR, false > csr_addr) {
         switch (csr_addr) {
         case USTATUS_A:
             return USTATUS_I;
@@ -656,7 +733,7 @@ SC_MODULE(execute) {
     // TODO: respect unwritable fields, see manual for each individual implemented CSR.
     // TODO: for now any bits of every register are fully readable/writeable.
     // TODO: This must be changed in future implementations.
-    void set_csr_value(sc_uint < CSR_IDX_LEN > csr_index, sc_uint < XLEN > rs1, sc_uint < LOG2_CSR_OP_NUM > operation, sc_uint < 2 > rw_permission) {
+    void set_csr_value(ac_int < CSR_IDX_LEN, false > csr_index, ac_int < XLEN, false > rs1, ac_int < LOG2_CSR_OP_NUM, false > operation, ac_int < 2, false > rw_permission) {
         if (rw_permission != 3)
             switch (operation) {
             case CSR_OP_WR:
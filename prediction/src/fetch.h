@@ -10,6 +10,13 @@
 
 		- Increment program counter based on new stall functionality.
 
+		- Fuses adjacent instruction pairs of the same I$ line, see FUSE_* in
+		  globals.h.
+
+		- Keeps fetching the predicted path without waiting for the branches to
+		  resolve. Execute redirects the fetch to the right path and starts a
+		  new epoch.
+
 
 */
 
@@ -25,6 +32,9 @@
 #include "drim4hls_datatypes.h"
 #include "defines.h"
 #include "globals.h"
+#include "../../common/replacement.h"
+#include "predictor.h"
+#include "profile.h"
 
 #include <mc_connections.h>
 #include <ac_int.h>
@@ -45,52 +55,83 @@ SC_MODULE(fetch) {
     sc_signal < ac_int < LOG2_NUM_CAUSES, false > > CCS_INIT_S1(trap_cause); //sc_out
 
     // *** Internal variables
-    sc_int < PC_LEN > pc; // Init. to -4, then before first insn fetch it will be updated to 0.	 
-    sc_uint < PC_LEN > imem_pc; // Used in fetching from instruction memory
-	sc_uint < PC_LEN > pc_tmp; // Init. to -4, then before first insn fetch it will be updated to 0. 
+    ac_int < PC_LEN, true > pc; // Pc of the current fetch
     // Custom datatypes used for retrieving and sending data through the channels
     imem_in_t imem_in; // Contains data for fetching from the instruction memory
     fe_out_t fe_out; // Contains data for the decode stage
     fe_in_t fetch_in; // Contains data from the decode stage used in incrementing the PC
     imem_out_t imem_out;
 		
-    bool redirect;
-    bool redirect_tmp;
-    
-    ras_data_t ra_stack[RAS_ENTRIES];
-    sc_uint < RAS_POINTER_SIZE > ras_pointer;
-    sc_uint < RAS_POINTER_SIZE > tosp_pointer;
-    
-    sc_uint < PC_LEN > mispredictions;
-    sc_uint < PC_LEN > correct_predictions;
-    sc_uint < PC_LEN > redirect_addr;
+    // Epoch of the fetched instructions. Execute bumps it on every redirect
+    // and decode squashes the instructions of the older epochs.
+    ac_int < TAG_WIDTH, false > epoch;
+    bool fe_pending; // fe_out is waiting for decode
 	
-	sc_uint < DATA_SIZE > mem_dout;
-    sc_uint < ICACHE_LINE > imem_data;
-    sc_uint < XLEN > imem_data_offset;
-    
-    sc_uint < ICACHE_TAG_WIDTH + ICACHE_INDEX_WIDTH + 1 > icache_buffer_addr[ICACHE_BUFFER_SIZE][ICACHE_WAYS];
-    sc_uint < ICACHE_LINE > icache_buffer_instr[ICACHE_BUFFER_SIZE][ICACHE_WAYS];
+	ac_int < DATA_SIZE, false > mem_dout;
+    ac_int < ICACHE_LINE, false > imem_data;
+    ac_int < XLEN, false > imem_data_offset;
     
     icache_data_t icache_data[ICACHE_ENTRIES][ICACHE_WAYS];
     icache_tag_t icache_tags[ICACHE_ENTRIES][ICACHE_WAYS];
     icache_out_t icache_out;
     
-    icache_data_t cache_data[1][ICACHE_WAYS];
-    icache_tag_t cache_tag[1][ICACHE_WAYS];
+    // Replacement metadata of every set. The data and tag arrays never move.
+    typedef repl_select < ICACHE_WAYS, ICACHE_REPL_POLICY >::type icache_repl_t;
+    static_assert(ICACHE_WAYS_WIDTH == repl_way_width < ICACHE_WAYS >::value, "ICACHE_WAYS_WIDTH does not address every way");
+    icache_repl_t icache_repl[ICACHE_ENTRIES];
+    ac_int < ICACHE_WAYS_WIDTH, false > way; // Way that hit, or victim way on a miss
     
-    btb_data_t btb_data[BTB_ENTRIES];
+    // Refill of the previous iteration. It is written to the arrays one
+    // iteration later, so lookups are bypassed from these registers.
+    bool fill_valid;
+    ac_int < ICACHE_INDEX_WIDTH, false > fill_index;
+    ac_int < ICACHE_WAYS_WIDTH, false > fill_way;
+    ac_int < ICACHE_TAG_WIDTH, false > fill_tag;
+    ac_int < ICACHE_LINE, false > fill_data;
+    predecode_t fill_predecode[ICACHE_LINE_WORDS];
+    
+    // Last line delivered by the I$. Consecutive fetches from the same line
+    // reuse it without reading the tag and data arrays.
+    bool line_valid;
+    ac_int < ICACHE_INDEX_WIDTH, false > line_index;
+    ac_int < ICACHE_TAG_WIDTH, false > line_tag;
+    ac_int < ICACHE_LINE, false > line_data;
+    predecode_t line_predecode[ICACHE_LINE_WORDS];
+    
+    // Way predictor. Holds for every set the way that hit last, only this
+    // way is read and its tag is verified after the access.
+    ac_int < ICACHE_WAYS_WIDTH, false > way_pred[ICACHE_ENTRIES];
+    bool way_replay; // Wrong way predicted but the line is present, fetch the pc again
+    #if defined(ICACHE_WAY_PREDICTION) && !defined(__SYNTHESIS__)
+    bool way_pred_first; // First access of the fetch, the replay of a wrong way is not counted
+    long int way_pred_correct;
+    long int way_pred_wrong;
+    #endif
+    
+    branch_pred_t bp; // BTB, direction, loop and indirect predictors and RAS
     btb_out_t btb_out;
-
-    sc_uint < ICACHE_TAG_WIDTH > tag;
-    sc_uint < ICACHE_INDEX_WIDTH > index;
-    sc_uint < ICACHE_OFFSET_WIDTH + 1 > offset;
+    #ifndef __SYNTHESIS__
+    branch_profile_t profile;
+    #endif
     
-    sc_uint < ICACHE_TAG_WIDTH + ICACHE_INDEX_WIDTH > buffer_addr;
+    // Loop buffer. Holds the body of a short loop closed by a predicted
+    // taken backward branch, which is then replayed without accessing the
+    // I$, the BTB and the RAS until execute redirects the fetch.
+    ac_int < XLEN, false > lb_instr[LOOP_BUFFER_ENTRIES];
+    predecode_t lb_predecode[LOOP_BUFFER_ENTRIES];
+    ac_int < PC_LEN, false > lb_start; // Target of the backward branch
+    ac_int < PC_LEN, false > lb_end; // pc of the backward branch
+    ac_int < LOOP_BUFFER_INDEX_WIDTH + 1, false > lb_count; // Instructions captured so far
+    ac_int < 2, false > lb_state;
+    #ifndef __SYNTHESIS__
+    long int lb_replayed;
+    #endif
+
+    ac_int < ICACHE_TAG_WIDTH, false > tag;
+    ac_int < ICACHE_INDEX_WIDTH, false > index;
+    ac_int < ICACHE_OFFSET_WIDTH + 1, false > offset;
 	
     bool freeze;
-    bool hit_buffer;
-    int position;
 	
     SC_CTOR(fetch): imem_din("imem_din"),
     fetch_din("fetch_din"),
@@ -114,35 +155,51 @@ SC_MODULE(fetch) {
             tag = 0;
             index= 0;
             offset = 0;
-            position = 0;
 									
             trap = 0;
             trap_cause = NULL_CAUSE;
             imem_in.instr_addr = 0;
             
-			ras_pointer = 0;
-			tosp_pointer = 0;
-            
-            redirect_addr = 0;
+            epoch = 0;
+            fe_pending = false;
 			freeze = false;
-			redirect = false;
-            //  Init. pc to START_ADDRESS - 4 as on first fetch it will be incremented by
-            //  4, thus fetching instruction at address 0
+            // The first fetch is at address 0
             pc = 0;
-            pc_tmp = -4;
-            buffer_addr = 0;
+            
+            way = 0;
+            fill_valid = false;
+            fill_index = 0;
+            fill_way = 0;
+            fill_tag = 0;
+            fill_data = 0;
+            
+            line_valid = false;
+            line_index = 0;
+            line_tag = 0;
+            line_data = 0;
+            
+            way_replay = false;
+            #if defined(ICACHE_WAY_PREDICTION) && !defined(__SYNTHESIS__)
+            way_pred_first = true;
+            way_pred_correct = 0;
+            way_pred_wrong = 0;
+            #endif
+            
+            lb_start = 0;
+            lb_end = 0;
+            lb_count = 0;
+            lb_state = LB_IDLE;
+            #ifndef __SYNTHESIS__
+            lb_replayed = 0;
+            #endif
             
             int n = 0;
-            int l = 0;
-            for (n = 0; n < ICACHE_BUFFER_SIZE; n++) {
-                for (l = 0; l < ICACHE_WAYS; l++) {             
-				    icache_buffer_addr[n][l] = 0;
-				    icache_buffer_instr[n][l] = 0;
-				}
+            for (n = 0; n < ICACHE_ENTRIES; n++) {
+				icache_repl[n].reset();
+				way_pred[n] = 0;
 			}
 			
-			mispredictions = 0;
-			correct_predictions = 0;
+			bp.reset();
             
             wait();
         }
@@ -151,116 +208,211 @@ SC_MODULE(fetch) {
         FETCH_BODY: while (true) {
             //sc_assert(sc_time_stamp().to_double() < 1500000);
 			
-			// step 1 fetch from memory/cache
-            hit_buffer = false;
-            fe_out.pc = pc;
-            
-            unsigned int aligned_addr = pc >> 2;
-            imem_in.instr_addr = aligned_addr;
-            
-            sc_uint < XLEN > addr = aligned_addr;
-            
-            tag = addr.range(ICACHE_TAG_WIDTH + ICACHE_INDEX_WIDTH + ICACHE_OFFSET_WIDTH - 1, ICACHE_INDEX_WIDTH + ICACHE_OFFSET_WIDTH);
-            index = addr.range(ICACHE_INDEX_WIDTH + ICACHE_OFFSET_WIDTH - 1,ICACHE_OFFSET_WIDTH);        
-			if (ICACHE_OFFSET_WIDTH) {
-                offset = addr.range(ICACHE_OFFSET_WIDTH - 1, 0);
-            }
-            else {
-				offset = 0;
-			}
-			
-			buffer_addr.range(ICACHE_INDEX_WIDTH - 1, 0) = index;
-			buffer_addr.range (ICACHE_TAG_WIDTH + ICACHE_INDEX_WIDTH - 1, ICACHE_INDEX_WIDTH) = tag;
-			
-			int m = 0;
-			int n = 0;
-			int k = ICACHE_BUFFER_SIZE - 1;
-			
-			for (k; k > 0; k = k - 1) {
-				for (m = 0; m < ICACHE_WAYS; m++) {
-					icache_buffer_addr[k][m] = icache_buffer_addr[k-1][m];
-					icache_buffer_instr[k][m] = icache_buffer_instr[k-1][m]; 
-				}                 
-			}
-			
-			icache_out = icache();
-			
-			for (m = 0; m < ICACHE_WAYS; m++) {                 
-				icache_buffer_instr[0][m] = cache_data[0][m].data;
-				icache_buffer_addr[0][m].range(0, 0) = (ac_int <1, false>) cache_tag[0][m].valid;
-				icache_buffer_addr[0][m].range(ICACHE_INDEX_WIDTH, 1) = index;
-				icache_buffer_addr[0][m].range(ICACHE_TAG_WIDTH + ICACHE_INDEX_WIDTH, ICACHE_INDEX_WIDTH + 1) = cache_tag[0][m].tag;
+			// step1 resolved branches and jumps from execute, redirect on a misprediction
+			if (fetch_din.PopNB(fetch_in)) {
+				bp.btb_write(fetch_in);
+				#ifndef __SYNTHESIS__
+				profile.resolved(fetch_in.pc.to_uint(), fetch_in.branch_taken);
+				#endif
+				if (fetch_in.redirect) {
+					bp.repair(fetch_in); // drop the directions, calls and returns of the wrong path
+					#ifndef __SYNTHESIS__
+					profile.mispredicted(fetch_in.pc.to_uint(), sc_time_stamp().to_double());
+					#endif
+					pc = fetch_in.address;
+					epoch = fetch_in.tag;
+					lb_state = LB_IDLE;
+					fe_pending = false; // the instruction waiting for decode is on the wrong path
+				}
 			}
 			
-			if (!icache_out.hit) {
-				for (n = 0; n < ICACHE_BUFFER_SIZE; n++) {
-					for (m = 0; m < ICACHE_WAYS; m++) {                 
-						if (icache_buffer_addr[n][m].range(ICACHE_TAG_WIDTH + ICACHE_INDEX_WIDTH, 1) == buffer_addr && icache_buffer_addr[n][m].range(0, 0) == 1) {
-							icache_out.data = icache_buffer_instr[n][m];
-							icache_out.hit = true;
-							hit_buffer = true;
-						}
-					}
+			// step2 fetch from memory/cache and predict the next pc, unless
+			// decode has not taken the previous instruction yet
+			if (!fe_pending) {
+				fe_out.pc = pc;
+
+				unsigned int aligned_addr = pc >> 2;
+				imem_in.instr_addr = aligned_addr;
+
+				ac_int < XLEN, false > addr = aligned_addr;
+
+				tag = addr.slc<ICACHE_TAG_WIDTH>(ICACHE_INDEX_WIDTH + ICACHE_OFFSET_WIDTH);
+				index = addr.slc<ICACHE_INDEX_WIDTH>(ICACHE_OFFSET_WIDTH);        
+				if (ICACHE_OFFSET_WIDTH) {
+					offset = addr.slc<ICACHE_OFFSET_WIDTH>(0);
 				}
-			}
-			int j = 0;
-            switch (icache_out.hit)
-            {
-				case CACHE_HIT:
-                    imem_data = icache_out.data;
-                    
-                    #pragma unroll yes
-					for (int i = 0; i < DATA_WIDTH; i++) {
-						int index = offset*DATA_WIDTH + i;
-						imem_data_offset[i] = imem_data[index];
+				else {
+					offset = 0;
+				}
+
+				#if defined(ICACHE_WAY_PREDICTION) && !defined(__SYNTHESIS__)
+				way_pred_first = !way_replay;
+				#endif
+				way_replay = false;
+				bool lb_hit = (lb_state == LB_REPLAY);
+				#ifdef ICACHE_LINE_REUSE
+				bool line_hit = line_valid && line_index == index && line_tag == tag;
+				#else
+				bool line_hit = false;
+				#endif
+
+				if (lb_hit) {
+					// The instruction comes from the loop buffer, the I$ is not accessed
+					icache_out.hit = true;
+					icache_out.data = 0;
+				} else if (line_hit) {
+					icache_out.hit = true;
+					icache_out.data = line_data;
+					#pragma unroll yes
+					for (int i = 0; i < ICACHE_LINE_WORDS; i++) {
+						icache_out.predecode[i] = line_predecode[i];
 					}
-                    
-                    fe_out.instr_data = imem_data_offset;
-                    break;
-                case CACHE_MISS:
-				                    
-                    imem_din.Push(imem_in);
-
-					imem_out = imem_dout.Pop();
-					
-                    imem_data = imem_out.instr_data;
+				} else {
+					#ifdef ICACHE_WAY_PREDICTION
+					icache_out = icache_predicted();
+					#else
+					icache_out = icache();
+					#endif
+				}
+
+				// Write the refill of the previous iteration
+				icache_write();
+
+				int j = 0;
+				switch (icache_out.hit)
+				{
+					case CACHE_HIT:
+						imem_data = icache_out.data;
+
+						#pragma unroll yes
+						for (int i = 0; i < DATA_WIDTH; i++) {
+							int index = offset*DATA_WIDTH + i;
+							imem_data_offset[i] = imem_data[index];
+						}
+
+						fe_out.instr_data = imem_data_offset;
+						fe_out.predecode = icache_out.predecode[offset];
+						break;
+					case CACHE_MISS:
+
+						imem_din.Push(imem_in);
+
+						imem_out = imem_dout.Pop();
+
+						imem_data = imem_out.instr_data;
+						#pragma unroll yes
+						for (int i = 0; i < DATA_WIDTH; i++) {
+							int index = offset*DATA_WIDTH + i;
+							imem_data_offset[i] = imem_data[index];
+						}
+						fe_out.instr_data = imem_data_offset;
+
+						// Pre-decode the whole line on refill
+						#pragma unroll yes
+						for (int i = 0; i < ICACHE_LINE_WORDS; i++) {
+							ac_int < XLEN, false > word = imem_data.slc<DATA_WIDTH>(i * DATA_WIDTH);
+							icache_out.predecode[i] = predecode(word);
+							fill_predecode[i] = icache_out.predecode[i];
+						}
+						fe_out.predecode = icache_out.predecode[offset];
+
+						fill_valid = true;
+						fill_index = index;
+						fill_way = way;
+						fill_tag = tag;
+						fill_data = imem_data;
+
+						break;
+					default:
+						break;
+				}
+
+				#ifdef MACRO_OP_FUSION
+				// Fuse with the next instruction of the same line. The loop
+				// buffer holds single instructions, so pairs are not fused
+				// while it captures or replays a loop.
+				fe_out.fuse = FUSE_NONE;
+				if (!lb_hit && lb_state == LB_IDLE && offset != ICACHE_LINE_WORDS - 1) {
+					ac_int < XLEN, false > next_instr = 0;
 					#pragma unroll yes
 					for (int i = 0; i < DATA_WIDTH; i++) {
-						int index = offset*DATA_WIDTH + i;
-						imem_data_offset[i] = imem_data[index];
+						int index = (offset + 1)*DATA_WIDTH + i;
+						next_instr[i] = imem_data[index];
 					}
+					fe_out.fuse = fuse_pair(imem_data_offset, next_instr);
+					if (fe_out.fuse != FUSE_NONE) {
+						// The pair is predicted as its second instruction
+						fe_out.fused_instr = next_instr;
+						fe_out.predecode = icache_out.predecode[offset + 1];
+					}
+				}
+				#endif
+
+				if (lb_hit) {
+					ac_int < PC_LEN, false > lb_offset = pc - lb_start;
+					imem_data_offset = lb_instr[lb_offset.slc<LOOP_BUFFER_INDEX_WIDTH>(2)];
 					fe_out.instr_data = imem_data_offset;
-					
-					icache_buffer_addr[0][ICACHE_WAYS - 1].range(0, 0) = 1;
-					icache_buffer_addr[0][ICACHE_WAYS - 1].range(ICACHE_TAG_WIDTH + ICACHE_INDEX_WIDTH, 1) = buffer_addr;
-					icache_buffer_instr[0][ICACHE_WAYS - 1] = imem_data;
-                    
-                    break;
-                default:
-                    break;
-            }
-            
-			icache_write();
-			
-			//step2 read from backchannel (decode)
-			if (position == 1 && !redirect) {
-				fetch_in = fetch_din.Pop();
-				redirect_addr = fetch_in.address;
+					fe_out.predecode = lb_predecode[lb_offset.slc<LOOP_BUFFER_INDEX_WIDTH>(2)];
+				} else {
+					line_valid = !way_replay;
+					line_index = index;
+					line_tag = tag;
+					line_data = imem_data;
+					#pragma unroll yes
+					for (int i = 0; i < ICACHE_LINE_WORDS; i++) {
+						line_predecode[i] = icache_out.predecode[i];
+					}
+				}
+
+				if (!way_replay) { // on a wrong I$ way prediction fetch the same pc again
+					if (lb_state == LB_REPLAY) { // loop body replay, predict the backward branch taken
+						bool lb_exit = false;
+						#ifdef LOOP_PREDICTOR
+						// unless the loop predictor expects the last iteration
+						lb_exit = (pc == lb_end) && bp.loop_pred.confident(lb_end.to_uint()) && !bp.loop_pred.predict(lb_end.to_uint());
+						#endif
+						// The body has no jumps, so the RAS is untouched. Its branches
+						// are replayed not taken but the backward one, and still move
+						// the speculative history and the loop iterations
+						if (fe_out.predecode.branch) {
+							bp.speculate(pc, pc == lb_end && !lb_exit);
+						}
+						pc = (pc == lb_end && !lb_exit) ? lb_start : (ac_int < PC_LEN, false >)(pc + 4);
+						if (lb_exit) {
+							lb_state = LB_IDLE;
+						}
+						#ifndef __SYNTHESIS__
+						lb_replayed++;
+						#endif
+					}else {
+						ac_int < PC_LEN, false > last_pc = (fe_out.fuse != FUSE_NONE) ? (ac_int < PC_LEN, false >)(pc + 4) : (ac_int < PC_LEN, false >) pc;
+						btb_out = bp.predict(last_pc, fe_out.predecode);
+						pc = (btb_out.btb_valid || btb_out.ras_valid) ? btb_out.bta : (ac_int < PC_LEN, false >)(last_pc + 4);
+						loop_buffer();
+					}
+					fe_out.next_pc = pc;
+					fe_out.tag = epoch;
+					fe_out.ras_top = bp.ras_top;
+					fe_out.ras_tos = bp.ra_stack[bp.ras_top].pc.to_uint();
+					fe_pending = true;
+				}
 			}else {
-				position = 1;
+				icache_write();
 			}
-			// step3 if instruction correct send it, update btb, ras and get new pc
-			if (redirect_addr == pc) {
-				btb_write();
-				ras_write();				
-				btb();
-				ras();
-				pc = (btb_out.btb_valid || btb_out.ras_valid) ? btb_out.bta : (ac_int < PC_LEN, false >)(pc + 4);
-				redirect = false;
-				dout.Push(fe_out);
-			}else { // step4 if instruction incorrect, redirect
-				pc = redirect_addr;
-				redirect = true;
+			
+			// step3 send the instruction, it is kept while decode stalls
+			if (fe_pending && dout.PushNB(fe_out)) {
+				fe_pending = false;
+				#ifndef __SYNTHESIS__
+				profile.refetched(sc_time_stamp().to_double());
+				if (fe_out.predecode.branch || fe_out.predecode.jal || fe_out.predecode.jalr) {
+					if (fe_out.fuse != FUSE_NONE) {
+						profile.fetched(fe_out.pc.to_uint() + 4, fe_out.fused_instr.to_uint());
+					}else {
+						profile.fetched(fe_out.pc.to_uint(), fe_out.instr_data.to_uint());
+					}
+				}
+				#endif
 			}
 			
 			#ifndef __SYNTHESIS__
@@ -272,141 +424,280 @@ SC_MODULE(fetch) {
         } // *** ENDOF while(true)
     } // *** ENDOF sc_cthread
     
+    #ifndef __SYNTHESIS__
+    void end_of_simulation() {
+        long int correct = bp.correct_predictions.to_uint();
+        long int branches = correct + bp.mispredictions.to_uint();
+        std::cout << "BRANCH PREDICTION: " << std::dec << correct << "/" << branches << " correct";
+        if (branches > 0) {
+            std::cout << " (" << (100.0 * correct) / branches << "%)";
+        }
+        std::cout << std::endl;
+        std::cout << "BTB: " << std::dec << bp.btb_lookups << " branch lookups, L0 hits " << bp.btb_l0_hits << ", L1 hits " << bp.btb_l1_hits;
+        if (bp.btb_lookups > 0) {
+            std::cout << " (" << (100.0 * bp.btb_l0_hits) / bp.btb_lookups << "% / " << (100.0 * bp.btb_l1_hits) / bp.btb_lookups << "%)";
+        }
+        std::cout << std::endl;
+        sc_clock * clock = dynamic_cast < sc_clock * > (clk.get_interface());
+        profile.report(clock ? clock->period().to_double() : 1.0, BRANCH_PROFILE_TOP);
+        #ifdef INDIRECT_PREDICTOR
+        std::cout << "INDIRECT PREDICTION: " << std::dec << bp.ind_correct << "/" << bp.ind_correct + bp.ind_wrong << " correct" << std::endl;
+        #endif
+        #ifdef ICACHE_WAY_PREDICTION
+        long int way_pred_total = way_pred_correct + way_pred_wrong;
+        std::cout << "I$ WAY PREDICTION: " << std::dec << way_pred_correct << "/" << way_pred_total << " correct";
+        if (way_pred_total > 0) {
+            std::cout << " (" << (100.0 * way_pred_correct) / way_pred_total << "%)";
+        }
+        std::cout << std::endl;
+        #endif
+        #ifdef LOOP_BUFFER
+        std::cout << "LOOP BUFFER: " << std::dec << lb_replayed << " instructions replayed" << std::endl;
+        #endif
+    }
+    #endif
+    
     icache_out_t icache () {
 
         icache_out_t iout;
-        icache_tag_t tmp_tag;
-        icache_data_t tmp_data;
         iout.data = 0;
         iout.hit = false;
 
+        // The refill of the previous iteration is not yet in the arrays
+        bool fill_set = fill_valid && fill_index == index;
+
+        bool invalid_found = false;
+        ac_int < ICACHE_WAYS_WIDTH, false > invalid_way = 0;
+
 		int i = 0;
-        int j = 0;
 
         for (i = 0; i < ICACHE_WAYS; i++) {
-            cache_tag[0][i] = icache_tags[index][i];
-            cache_data[0][i] = icache_data[index][i];
+            icache_tag_t way_tag = icache_tags[index][i];
+            
+            if (fill_set && fill_way == i) {
+				way_tag.tag = fill_tag;
+				way_tag.valid = true;
+			}
 
-            if ((tag == cache_tag[0][i].tag) && (cache_tag[0][i].valid)) {
-                              
-                tmp_data = cache_data[0][i];
-                tmp_tag = cache_tag[0][i];
+            if ((tag == way_tag.tag) && (way_tag.valid)) {
+                iout.data = (fill_set && fill_way == i) ? fill_data : icache_data[index][i].data;
+                #pragma unroll yes
+                for (int w = 0; w < ICACHE_LINE_WORDS; w++) {
+                    iout.predecode[w] = (fill_set && fill_way == i) ? fill_predecode[w] : icache_data[index][i].predecode[w];
+                }
                 iout.hit = true;
-                j = i;
+                way = i;
+            } else if (!way_tag.valid && !invalid_found) {
+				invalid_way = i;
+				invalid_found = true;
+			}
 
-            }
+		}
 
+        if (iout.hit) {
+            icache_repl[index].touch(way);
+		} else {
+			way = invalid_found ? invalid_way : (ac_int < ICACHE_WAYS_WIDTH, false >) icache_repl[index].victim();
+			icache_repl[index].insert(way);
 		}
-		
-		for (i = ICACHE_WAYS - 1; i > 0; i--) {
-			if (iout.hit && i <= j) {
-				cache_data[0][i] = cache_data[0][i-1];
-				cache_tag[0][i] = cache_tag[0][i-1];
-			}
-				
+
+        return iout;
+    }
+    
+    icache_out_t icache_predicted () {
+
+        icache_out_t iout;
+        iout.data = 0;
+        iout.hit = false;
+
+        bool fill_set = fill_valid && fill_index == index;
+        ac_int < ICACHE_WAYS_WIDTH, false > pred = way_pred[index];
+
+        // Access only the predicted way and verify its tag
+        icache_tag_t pred_tag = icache_tags[index][pred];
+        if (fill_set && fill_way == pred) {
+			pred_tag.tag = fill_tag;
+			pred_tag.valid = true;
 		}
 
-        if (iout.hit) {
-			
-            cache_data[0][0] = tmp_data;
-            cache_tag[0][0] = tmp_tag;
-		}else {
-			tmp_data = cache_data[0][ICACHE_WAYS - 1];
+        if ((tag == pred_tag.tag) && (pred_tag.valid)) {
+            iout.data = (fill_set && fill_way == pred) ? fill_data : icache_data[index][pred].data;
+            #pragma unroll yes
+            for (int w = 0; w < ICACHE_LINE_WORDS; w++) {
+                iout.predecode[w] = (fill_set && fill_way == pred) ? fill_predecode[w] : icache_data[index][pred].predecode[w];
+            }
+            iout.hit = true;
+            way = pred;
+            icache_repl[index].touch(way);
+            #if defined(ICACHE_WAY_PREDICTION) && !defined(__SYNTHESIS__)
+            if (way_pred_first) {
+                way_pred_correct++;
+            }
+            #endif
+            return iout;
+        }
+
+        // Wrong way: compare the remaining tags, no data is read
+        bool tag_hit = false;
+        bool invalid_found = false;
+        ac_int < ICACHE_WAYS_WIDTH, false > invalid_way = 0;
+
+		int i = 0;
+
+        for (i = 0; i < ICACHE_WAYS; i++) {
+            icache_tag_t way_tag = icache_tags[index][i];
+
+            if (fill_set && fill_way == i) {
+				way_tag.tag = fill_tag;
+				way_tag.valid = true;
+			}
+
+            if ((tag == way_tag.tag) && (way_tag.valid)) {
+                tag_hit = true;
+                way = i;
+            } else if (!way_tag.valid && !invalid_found) {
+				invalid_way = i;
+				invalid_found = true;
+			}
 		}
 
-        iout.data = tmp_data.data;
+        if (tag_hit) {
+            // The line is read from the right way on the next cycle
+            way_replay = true;
+            iout.hit = true;
+            #if defined(ICACHE_WAY_PREDICTION) && !defined(__SYNTHESIS__)
+            if (way_pred_first) {
+                way_pred_wrong++;
+            }
+            #endif
+		} else {
+			way = invalid_found ? invalid_way : (ac_int < ICACHE_WAYS_WIDTH, false >) icache_repl[index].victim();
+			icache_repl[index].insert(way);
+		}
+        way_pred[index] = way;
 
         return iout;
     }
     
     void icache_write () {
-			
-        sc_uint < ICACHE_INDEX_WIDTH > write_index = icache_buffer_addr[1][0].range(ICACHE_INDEX_WIDTH, 1);
-        int i = 0;
-        for (i = 0; i < ICACHE_WAYS; i++) {                 
 
-			if (hit_buffer) {
-				icache_buffer_instr[0][i] = icache_buffer_instr[1][i];
-				icache_buffer_addr[0][i] = icache_buffer_addr[1][i];
+        if (fill_valid) {
+			icache_data[fill_index][fill_way].data = fill_data;
+			#pragma unroll yes
+			for (int i = 0; i < ICACHE_LINE_WORDS; i++) {
+				icache_data[fill_index][fill_way].predecode[i] = fill_predecode[i];
 			}
-			icache_data[write_index][i].data = icache_buffer_instr[1][i];
-			icache_tags[write_index][i].valid = icache_buffer_addr[1][i].range(0,0);
-			icache_tags[write_index][i].tag = icache_buffer_addr[1][i].range(ICACHE_INDEX_WIDTH + ICACHE_TAG_WIDTH, 1 + ICACHE_INDEX_WIDTH);
-        }
-                      
+			icache_tags[fill_index][fill_way].tag = fill_tag;
+			icache_tags[fill_index][fill_way].valid = true;
+		}
+		fill_valid = false;
 
     }
     
-    void btb () {     
-        sc_uint < BTB_INDEX_WIDTH > next_index = pc.range(BTB_INDEX_WIDTH - 1 ,0).to_uint();
-		sc_uint < BTB_TAG_WIDTH > next_tag = pc.range(BTB_INDEX_WIDTH + BTB_TAG_WIDTH - 1, BTB_INDEX_WIDTH).to_uint();
-        
-        if(next_tag == btb_data[next_index].tag && btb_data[next_index].prediction_data > WEAK_NON_TAKEN) {
-            btb_out.bta = btb_data[next_index].bta;
-            btb_out.btb_valid = true;
-        }
-        else {
-            btb_out.btb_valid = false;
-        }
-    }
-    
-    void btb_write () {
-		sc_uint < PC_LEN > update_pc = fetch_in.pc;
-		sc_uint < BTB_INDEX_WIDTH > index = update_pc.range(BTB_INDEX_WIDTH - 1, 0).to_uint();
-		sc_uint < BTB_TAG_WIDTH > tag = update_pc.range(BTB_INDEX_WIDTH + BTB_TAG_WIDTH - 1, BTB_INDEX_WIDTH).to_uint();
+	void loop_buffer() {
+		#ifdef LOOP_BUFFER
+		ac_int < PC_LEN, false > curr_pc = fe_out.pc;
+		if (fe_out.fuse != FUSE_NONE) {
+			curr_pc = curr_pc + 4; // the branch of a fused compare-and-branch
+		}
+		ac_int < PC_LEN, false > lb_offset = curr_pc - lb_start;
 		
-		btb_data_t data = btb_data[index];
-        //check if tag or branch target address differ in branch target buffer
-        if (fetch_in.btb_update) {
-            if(tag != data.tag || fetch_in.bta != data.bta) {
-                btb_data[index].tag = tag;
-                btb_data[index].bta = fetch_in.bta;
-                btb_data[index].prediction_data = WEAK_NON_TAKEN;
-                if (fetch_in.branch_taken) {
-					mispredictions++;
-				}    
-                
-            }else if (fetch_in.branch_taken && btb_data[index].prediction_data < STRONG_TAKEN){
-                btb_data[index].prediction_data = btb_data[index].prediction_data + 1;
-                if(btb_data[index].prediction_data > WEAK_NON_TAKEN + 1) {
-					correct_predictions++;
-				}else {
-					mispredictions++;
-				}
-            }else if (!fetch_in.branch_taken && btb_data[index].prediction_data > 0) {
-                btb_data[index].prediction_data = btb_data[index].prediction_data - 1;
-                if(btb_data[index].prediction_data > WEAK_NON_TAKEN-1) {
-					mispredictions++;
-				}else {
-					correct_predictions++;
+		if (lb_state == LB_CAPTURE) {
+			// Jumps and taken branches inside the body stop the capture
+			if (fe_out.predecode.jal || fe_out.predecode.jalr || lb_offset != ((ac_int < PC_LEN, false >) lb_count << 2)) {
+				lb_state = LB_IDLE;
+			}else {
+				lb_instr[lb_count] = fe_out.instr_data;
+				lb_predecode[lb_count] = fe_out.predecode;
+				lb_count = lb_count + 1;
+				if (curr_pc == lb_end) {
+					lb_state = (btb_out.btb_valid && btb_out.bta == lb_start) ? LB_REPLAY : LB_IDLE;
 				}
-                
-            }else {
-				correct_predictions++;
 			}
-        }
+		}else if (fe_out.predecode.branch && btb_out.btb_valid && btb_out.bta < curr_pc && (curr_pc - btb_out.bta) < (LOOP_BUFFER_ENTRIES << 2)) {
+			// Short backward branch predicted taken, capture the next iteration
+			lb_start = btb_out.bta;
+			lb_end = curr_pc;
+			lb_count = 0;
+			lb_state = LB_CAPTURE;
+		}
+		#endif
 	}
 	
-	void ras() {
-		
-		if (imem_data_offset.range(6, 2) == OPC_JALR && ra_stack[ras_pointer].valid) {
-			btb_out.ras_valid = true;
-			btb_out.bta = ra_stack[ras_pointer].pc;
-			ra_stack[ras_pointer].valid = false;
-			tosp_pointer = tosp_pointer - 1;
-			ras_pointer = tosp_pointer - 1;
-		}else {
-			btb_out.ras_valid = false;
+	// Kind of macro-op fusion of two adjacent instructions, see globals.h.
+	// Both write the same rd and the second reads it, so the fused operation
+	// has a single destination.
+	ac_int < FUSE_WIDTH, false > fuse_pair(ac_int < XLEN, false > first, ac_int < XLEN, false > second) {
+		ac_int < OPCODE_SIZE, false > opcode1 = first.slc<5>(2);
+		ac_int < OPCODE_SIZE, false > opcode2 = second.slc<5>(2);
+		ac_int < 3, false > funct3_1 = first.slc<3>(12);
+		ac_int < 3, false > funct3_2 = second.slc<3>(12);
+		ac_int < FUNCT7_SIZE, false > funct7_1 = first.slc<7>(25);
+		ac_int < FUNCT7_SIZE, false > funct7_2 = second.slc<7>(25);
+		ac_int < REG_ADDR, false > rd1 = first.slc<5>(7);
+		ac_int < REG_ADDR, false > rd2 = second.slc<5>(7);
+		ac_int < REG_ADDR, false > rs1_2 = second.slc<5>(15);
+		ac_int < REG_ADDR, false > rs2_2 = second.slc<5>(20);
+		bool chained = (rd1 != 0 && rd2 == rd1 && rs1_2 == rd1);
+		bool compare = ((opcode1 == OPC_SLT && funct7_1 == FUNCT7_SLT) || opcode1 == OPC_SLTI) && (funct3_1 == FUNCT3_SLT || funct3_1 == FUNCT3_SLTU);
+
+		if (opcode1 == OPC_LUI && opcode2 == OPC_ADDI && funct3_2 == FUNCT3_ADDI && chained) {
+			return FUSE_LUI_ADDI;
+		}else if (opcode1 == OPC_AUIPC && opcode2 == OPC_JALR && chained) {
+			return FUSE_AUIPC_JALR;
+		}else if (opcode1 == OPC_AUIPC && opcode2 == OPC_LW && chained) {
+			return FUSE_AUIPC_LOAD;
+		}else if (opcode1 == OPC_SLLI && funct3_1 == FUNCT3_SLLI && funct7_1 == FUNCT7_SLLI &&
+			opcode2 == OPC_ADD && funct3_2 == FUNCT3_ADD && funct7_2 == FUNCT7_ADD &&
+			rd1 != 0 && rd2 == rd1 && ((rs1_2 == rd1) != (rs2_2 == rd1))) {
+			return FUSE_SLLI_ADD;
+		}else if (compare && rd1 != 0 && opcode2 == OPC_BEQ && rs1_2 == rd1 && rs2_2 == 0) {
+			if (funct3_2 == FUNCT3_BEQ) {
+				return FUSE_CMP_BEQZ;
+			}else if (funct3_2 == FUNCT3_BNE) {
+				return FUSE_CMP_BNEZ;
+			}
 		}
+		return FUSE_NONE;
 	}
-	
-	void ras_write() {
-		if (fetch_in.ras_update) {
-			ra_stack[tosp_pointer].pc = fetch_in.pc + 4;
-			ra_stack[tosp_pointer].valid = true;
-			tosp_pointer = tosp_pointer + 1;
-			ras_pointer = tosp_pointer - 1;
+
+	// Pre-decoded bits of an instruction, computed when its line is refilled.
+	// Branch offsets are sign-extended to the JAL offset width.
+	predecode_t predecode(ac_int < XLEN, false > insn) {
+		predecode_t pd;
+		ac_int < OPCODE_SIZE, false > opcode = insn.slc<5>(2);
+		ac_int < REG_ADDR, false > rd = insn.slc<5>(7);
+		ac_int < REG_ADDR, false > rs1 = insn.slc<5>(15);
+		bool rd_link = (rd == 1 || rd == 5);
+		bool rs1_link = (rs1 == 1 || rs1 == 5);
+		
+		pd.branch = (opcode == OPC_BEQ);
+		pd.jal = (opcode == OPC_JAL);
+		pd.jalr = (opcode == OPC_JALR);
+		pd.call = (pd.jal || pd.jalr) && rd_link;
+		pd.ret = pd.jalr && rs1_link && !rd_link;
+		pd.ldst = (opcode == OPC_LW || opcode == OPC_SW);
+		pd.multicycle = (opcode == OPC_MUL && insn.slc<7>(25) == FUNCT7_MUL);
+		
+		if (pd.jal) {
+			pd.imm = 0;
+			pd.imm.set_slc(1, insn.slc<10>(21));
+			pd.imm[11] = insn[20];
+			pd.imm.set_slc(12, insn.slc<8>(12));
+			pd.imm[20] = insn[31];
+		}else {
+			ac_int < 13, false > immbranch = 0;
+			immbranch.set_slc(1, insn.slc<4>(8));
+			immbranch.set_slc(5, insn.slc<6>(25));
+			immbranch[11] = insn[7];
+			immbranch[12] = insn[31];
+			pd.imm = immbranch;
+			if (immbranch[12] == 1) {
+				pd.imm.set_slc(13, (ac_int < PREDECODE_IMM_WIDTH - 13, false >) 255);
+			}
 		}
+		
+		return pd;
 	}
 };
 
@@ -267,6 +267,8 @@
 #define ALUOP_CSRRSI  29
 #define ALUOP_CSRRCI  30
 
+#define ALUOP_SHADD   31    // Fused SLLI+ADD: rd = (rs1 << shamt) + rs2
+
 /* ALU Source discrimination values */
 #define ALUSRC_RS2      0
 #define ALUSRC_IMM_I    1
@@ -320,4 +322,19 @@
 #define CACHE_HIT true
 #define CACHE_MISS false
 
+/* Macro-op fusion. Adjacent pairs with the same rd that are fetched from
+   the same I$ line are sent to decode as one operation. */
+#define FUSE_NONE        0
+#define FUSE_LUI_ADDI    1   // lui rd, hi; addi rd, rd, lo
+#define FUSE_AUIPC_JALR  2   // auipc rd, hi; jalr rd, lo(rd)
+#define FUSE_AUIPC_LOAD  3   // auipc rd, hi; l{b,h,w}[u] rd, lo(rd)
+#define FUSE_SLLI_ADD    4   // slli rd, rs1, sh; add rd, rd, rs2
+#define FUSE_CMP_BEQZ    5   // slt[i][u] rd, ...; beq rd, x0, target
+#define FUSE_CMP_BNEZ    6   // slt[i][u] rd, ...; bne rd, x0, target
+
+/* Loop buffer states */
+#define LB_IDLE     0   // Looking for a short backward branch
+#define LB_CAPTURE  1   // Storing the loop body
+#define LB_REPLAY   2   // Fetching the loop body from the loop buffer
+
 #endif
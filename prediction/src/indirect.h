@@ -0,0 +1,82 @@
+/*
+	@author VLSI Lab, EE dept., Democritus University of Thrace
+
+	@brief Header file for the indirect jump target predictor
+
+	@note
+		- Predicts the target of the JALRs that are not returns (switch
+		  tables, function pointers, interpreter dispatch). Returns are
+		  left to the RAS.
+
+		- The table is indexed by the pc XOR a path history made of the low
+		  bits of the last indirect jump targets, so the same JALR can hold
+		  a different target for every path that leads to it.
+
+		- Interface:
+			reset()              initializes the table and the path history
+			predict(pc, target)  returns true and the target if the JALR at pc hits
+			update(pc, target)   writes the resolved target and extends the path
+
+		- Only ac_int is used, so the predictor can also be compiled on the
+		  host without SystemC.
+
+*/
+
+#ifndef __INDIRECT__H
+#define __INDIRECT__H
+
+#include "defines.h"
+#include "globals.h"
+#include "direction.h"
+
+#include <ac_int.h>
+
+template < int INDEX_WIDTH >
+struct indirect_pred_t {
+    static const int ENTRIES = 1 << INDEX_WIDTH;
+
+    bool valid[ENTRIES];
+    ac_int < IND_PRED_TAG_WIDTH, false > tag[ENTRIES];
+    dir_pc_t target[ENTRIES];
+    ac_int < IND_PRED_PATH_WIDTH, false > path;
+
+    void reset() {
+        for (int i = 0; i < ENTRIES; i++) {
+            valid[i] = false;
+            tag[i] = 0;
+            target[i] = 0;
+        }
+        path = 0;
+    }
+
+    ac_int < INDEX_WIDTH, false > index(dir_pc_t pc) {
+        ac_int < INDEX_WIDTH, false > folded = pc.slc < INDEX_WIDTH > (2);
+        #pragma unroll yes
+        for (int b = 0; b < IND_PRED_PATH_WIDTH; b++) {
+            folded[b % INDEX_WIDTH] = folded[b % INDEX_WIDTH] ^ path[b];
+        }
+        return folded;
+    }
+
+    ac_int < IND_PRED_TAG_WIDTH, false > entry_tag(dir_pc_t pc) {
+        return pc.slc < IND_PRED_TAG_WIDTH > (2 + INDEX_WIDTH);
+    }
+
+    bool predict(dir_pc_t pc, dir_pc_t & pred_target) {
+        ac_int < INDEX_WIDTH, false > i = index(pc);
+        pred_target = target[i];
+        return valid[i] && tag[i] == entry_tag(pc);
+    }
+
+    void update(dir_pc_t pc, dir_pc_t resolved_target) {
+        ac_int < INDEX_WIDTH, false > i = index(pc);
+        valid[i] = true;
+        tag[i] = entry_tag(pc);
+        target[i] = resolved_target;
+
+        ac_int < IND_PRED_PATH_BITS, false > target_bits = resolved_target.slc < IND_PRED_PATH_BITS > (2);
+        path = (path << IND_PRED_PATH_BITS) ^ target_bits;
+    }
+};
+
+#endif
@@ -0,0 +1,187 @@
+/*
+	@author VLSI Lab, EE dept., Democritus University of Thrace
+
+	@brief Header file for issue stage
+
+	@note
+		- Only instantiated when DECODE_SPLIT is defined. Decode builds the
+		  control word and this stage reads the operands and issues the
+		  instruction to execute, so the decoder and the bypass network are
+		  no longer in the same cycle.
+
+		- The register file, the scoreboard and the hazard checks are the
+		  ones of the unsplit decode, see regread.h. Execute forwards to this
+		  stage and writeback writes back to it.
+
+		- Instructions of an older epoch are squashed here. A misprediction
+		  costs one more cycle than with the unsplit decode.
+
+*/
+
+#ifndef __ISS__H
+#define __ISS__H
+
+#include "drim4hls_datatypes.h"
+#include "defines.h"
+#include "globals.h"
+#include "regread.h"
+
+#include <mc_connections.h>
+
+SC_MODULE(issue) {
+    public:
+    // Clock and reset signals
+    sc_in < bool > CCS_INIT_S1(clk);
+    sc_in < bool > CCS_INIT_S1(rst);
+    // FlexChannel initiators
+    Connections::In < de_iss_t > CCS_INIT_S1(din);
+    Connections::Out < de_out_t > CCS_INIT_S1(dout);
+    Connections::In < mem_out_t > CCS_INIT_S1(feed_from_wb);
+    Connections::In < reg_forward_t > CCS_INIT_S1(fwd_exe);
+
+    // End of simulation signal.
+    sc_out < bool > CCS_INIT_S1(program_end);
+
+    // Instruction counters
+    sc_out < long int > CCS_INIT_S1(icount);
+    sc_out < long int > CCS_INIT_S1(j_icount);
+    sc_out < long int > CCS_INIT_S1(b_icount);
+    sc_out < long int > CCS_INIT_S1(m_icount);
+    sc_out < long int > CCS_INIT_S1(o_icount);
+
+    regread_t rr; // Register file, scoreboard and hazard checks
+
+    de_iss_t input; // Contains data from the decode stage
+    de_out_t output; // Contains data for the execute stage
+    bool squash;
+    int position_fwd;
+    int position_wb;
+
+    #ifndef __SYNTHESIS__
+    long int fused_pairs;
+    #endif
+
+    SC_CTOR(issue): clk("clk"),
+    rst("rst"),
+    din("din"),
+    dout("dout"),
+    feed_from_wb("feed_from_wb"),
+    fwd_exe("fwd_exe"),
+    program_end("program_end"),
+    icount("icount"),
+    j_icount("j_icount"),
+    b_icount("b_icount"),
+    m_icount("m_icount"),
+    o_icount("o_icount") {
+
+        SC_THREAD(issue_th);
+        sensitive << clk.pos();
+        async_reset_signal_is(rst, false);
+
+    }
+
+    void issue_th(void) {
+        ISSUE_RST: {
+            din.Reset();
+            dout.Reset();
+            feed_from_wb.Reset();
+            fwd_exe.Reset();
+            rr.reset();
+            #ifndef __SYNTHESIS__
+            fused_pairs = 0;
+            #endif
+
+            // Program has not completed
+            program_end.write(false);
+            icount.write(0); // any
+            j_icount.write(0); // jump
+            b_icount.write(0); // branch
+            m_icount.write(0); // load, store
+            o_icount.write(0); // other
+
+            input = de_iss_t();
+            squash = false;
+            position_fwd = 0;
+            position_wb = 0;
+
+            wait();
+        }
+
+        #pragma hls_pipeline_init_interval 1
+        #pragma pipeline_stall_mode flush
+        ISSUE_BODY: while (true) {
+            // A stalled instruction is issued again, decode keeps the next one.
+            if (!rr.freeze) {
+                input = din.Pop();
+            }
+
+            if (position_fwd == 1) {
+                rr.forward(fwd_exe.Pop());
+            }else {
+                position_fwd = 1;
+            }
+            // Wrong-path instruction, fetched before execute redirected the fetch
+            squash = (input.tag != rr.epoch);
+
+            if (position_wb == 2) {
+                rr.writeback(feed_from_wb.Pop());
+            }else {
+                position_wb++;
+            }
+            rr.release();
+
+            output = input.op;
+            predecode_t pd = output.predecode;
+            bool fused = (output.fuse != FUSE_NONE);
+
+            if (squash) {
+                // Not counted
+            }else if (output.ld != NO_LOAD || output.st != NO_STORE) {
+                m_icount.write(m_icount.read() + 1);
+            }else if (pd.jal || pd.jalr) {
+                j_icount.write(j_icount.read() + 1);
+            }else if (pd.branch) {
+                b_icount.write(b_icount.read() + 1);
+            }else {
+                o_icount.write(o_icount.read() + 1);
+            }
+            if (!squash) {
+                icount.write(icount.read() + (fused ? 2 : 1));
+            }
+            if (!squash && fused) {
+                // The first instruction of a fused pair
+                o_icount.write(o_icount.read() + 1);
+                #ifndef __SYNTHESIS__
+                fused_pairs++;
+                #endif
+            }
+
+            if (input.halt && !squash) {
+                // jump to yourself (end of program).
+                program_end.write(true);
+            }
+
+            rr.read(input.rs1_addr, input.rs2_addr, output);
+            if (input.rs1_const) {
+                output.rs1 = input.op.rs1;
+            }
+
+            rr.issue(output, squash, input.bubble);
+
+            dout.Push(output);
+
+            wait();
+        }
+    }
+
+    #ifndef __SYNTHESIS__
+    void end_of_simulation() {
+        rr.report();
+        #ifdef MACRO_OP_FUSION
+        std::cout << "MACRO-OP FUSION: " << std::dec << fused_pairs << " pairs fused" << std::endl;
+        #endif
+    }
+    #endif
+};
+
+#endif
@@ -0,0 +1,332 @@
+/*
+	@author VLSI Lab, EE dept., Democritus University of Thrace
+
+	@brief Header file for the branch predictor of the fetch stage
+
+	@note
+		- Holds the two-level BTB, the direction, loop and indirect
+		  predictors and the RAS. It is a plain class, so the same code is
+		  used by the fetch stage and by the trace-driven evaluator in
+		  prediction/tools, which runs without the SystemC kernel.
+
+		- Interface:
+			reset()                initializes the tables
+			predict(pc, pd)        looks up the BTB, the predictors and the RAS
+			                       for the pre-decoded instruction at pc
+			btb_write(fetch_in)    trains the tables with a resolved instruction
+			repair(fetch_in)       drops the speculative state of the wrong path
+
+*/
+
+#ifndef __PREDICTOR__H
+#define __PREDICTOR__H
+
+#include "drim4hls_datatypes.h"
+#include "defines.h"
+#include "globals.h"
+#include "../../common/replacement.h"
+#include "direction.h"
+#include "indirect.h"
+
+#include <mc_connections.h>
+#include <ac_int.h>
+
+struct branch_pred_t {
+    // Two-level BTB. The small fully associative L0 holds the most recently
+    // used targets with full tags, the set associative L1 backs it with
+    // partial tags. L1 hits are promoted to the L0.
+    ac_int < PC_LEN - 2, false > btb_l0_tag[BTB_L0_ENTRIES];
+    ac_int < PC_LEN, false > btb_l0_bta[BTB_L0_ENTRIES];
+    bool btb_l0_valid[BTB_L0_ENTRIES];
+    typedef repl_select < BTB_L0_ENTRIES, BTB_REPL_POLICY >::type btb_l0_repl_t;
+    static_assert(BTB_L0_INDEX_WIDTH == repl_way_width < BTB_L0_ENTRIES >::value, "BTB_L0_INDEX_WIDTH does not address every entry");
+    btb_l0_repl_t btb_l0_repl;
+
+    btb_data_t btb_data[BTB_ENTRIES][BTB_WAYS];
+    typedef repl_select < BTB_WAYS, BTB_REPL_POLICY >::type btb_repl_t;
+    static_assert(BTB_WAYS_WIDTH == repl_way_width < BTB_WAYS >::value, "BTB_WAYS_WIDTH does not address every way");
+    btb_repl_t btb_repl[BTB_ENTRIES];
+    btb_out_t btb_out;
+    #ifndef __SYNTHESIS__
+    long int btb_lookups;
+    long int btb_l0_hits;
+    long int btb_l1_hits;
+    #endif
+
+    typedef dir_pred_select < DIR_PRED_POLICY >::type dir_pred_t;
+    dir_pred_t dir_pred; // Direction of the branches that hit in the BTB
+    loop_pred_t < LOOP_PRED_INDEX_WIDTH > loop_pred;
+    indirect_pred_t < IND_PRED_INDEX_WIDTH > ind_pred;
+    #ifndef __SYNTHESIS__
+    long int ind_correct;
+    long int ind_wrong;
+    #endif
+
+    // Circular return address stack, pushed on calls and popped on returns
+    // at fetch. The pointer wraps around, so overflows lose the oldest entry.
+    ras_data_t ra_stack[RAS_ENTRIES];
+    ac_int < RAS_POINTER_SIZE, false > ras_top;
+
+    ac_int < PC_LEN, false > mispredictions;
+    ac_int < PC_LEN, false > correct_predictions;
+
+    void reset() {
+        int n = 0;
+        for (n = 0; n < BTB_L0_ENTRIES; n++) {
+            btb_l0_valid[n] = false;
+        }
+        btb_l0_repl.reset();
+        for (n = 0; n < BTB_ENTRIES; n++) {
+            for (int w = 0; w < BTB_WAYS; w++) {
+                btb_data[n][w].valid = false;
+            }
+            btb_repl[n].reset();
+        }
+        #ifndef __SYNTHESIS__
+        btb_lookups = 0;
+        btb_l0_hits = 0;
+        btb_l1_hits = 0;
+        #endif
+        dir_pred.reset();
+        loop_pred.reset();
+        ind_pred.reset();
+        #ifndef __SYNTHESIS__
+        ind_correct = 0;
+        ind_wrong = 0;
+        #endif
+
+        ras_top = 0;
+
+        mispredictions = 0;
+        correct_predictions = 0;
+    }
+
+    btb_out_t predict(ac_int < PC_LEN, false > pc, predecode_t pd) {
+        btb(pc, pd);
+        jal(pc, pd);
+        ras(pc, pd);
+        indirect(pc, pd);
+        return btb_out;
+    }
+
+    void repair(fe_in_t fetch_in) {
+        dir_pred.repair(); // drop the directions speculated on the wrong path
+        #ifdef LOOP_PREDICTOR
+        loop_pred.repair(); // and the iterations
+        #endif
+        ras_restore(fetch_in); // and the calls and returns
+    }
+
+    bool btb_l0_find (ac_int < PC_LEN, false > addr, ac_int < BTB_L0_INDEX_WIDTH, false > & entry) {
+        bool hit = false;
+        #pragma unroll yes
+        for (int i = 0; i < BTB_L0_ENTRIES; i++) {
+            if (btb_l0_valid[i] && btb_l0_tag[i] == addr.slc<PC_LEN - 2>(2)) {
+                hit = true;
+                entry = i;
+            }
+        }
+        return hit;
+    }
+
+    bool btb_l1_find (ac_int < PC_LEN, false > addr, ac_int < BTB_WAYS_WIDTH, false > & btb_way) {
+        ac_int < BTB_INDEX_WIDTH, false > btb_index = addr.slc<BTB_INDEX_WIDTH>(2);
+        ac_int < BTB_TAG_WIDTH, false > btb_tag = addr.slc<BTB_TAG_WIDTH>(BTB_INDEX_WIDTH + 2);
+        bool hit = false;
+        #pragma unroll yes
+        for (int i = 0; i < BTB_WAYS; i++) {
+            if (btb_data[btb_index][i].valid && btb_data[btb_index][i].tag == btb_tag) {
+                hit = true;
+                btb_way = i;
+            }
+        }
+        return hit;
+    }
+
+    void btb (ac_int < PC_LEN, false > pc, predecode_t pd) {
+        ac_int < PC_LEN, false > addr = pc;
+        ac_int < BTB_INDEX_WIDTH, false > btb_index = addr.slc<BTB_INDEX_WIDTH>(2);
+        ac_int < BTB_L0_INDEX_WIDTH, false > entry = 0;
+        ac_int < BTB_WAYS_WIDTH, false > btb_way = 0;
+        ac_int < PC_LEN, false > bta = 0;
+
+        // Only pre-decoded branches look up the BTB. A partial tag of the L1
+        // can alias with any other instruction, which must not be predicted
+        // taken nor promoted to the L0.
+        bool l0_hit = pd.branch && btb_l0_find(addr, entry);
+        bool l1_hit = pd.branch && !l0_hit && btb_l1_find(addr, btb_way);
+
+        if (l0_hit) {
+            bta = btb_l0_bta[entry];
+            btb_l0_repl.touch(entry);
+        }else if (l1_hit) {
+            bta = btb_data[btb_index][btb_way].bta;
+            btb_repl[btb_index].touch(btb_way);
+
+            // Promote to the L0
+            entry = btb_l0_repl.victim();
+            btb_l0_tag[entry] = addr.slc<PC_LEN - 2>(2);
+            btb_l0_bta[entry] = bta;
+            btb_l0_valid[entry] = true;
+            btb_l0_repl.insert(entry);
+        }
+
+        #ifndef __SYNTHESIS__
+        if (pd.branch) {
+            btb_lookups++;
+        }
+        if (l0_hit) {
+            btb_l0_hits++;
+        }else if (l1_hit) {
+            btb_l1_hits++;
+        }
+        #endif
+
+        if((l0_hit || l1_hit) && direction(pc)) {
+            btb_out.bta = bta;
+            btb_out.btb_valid = true;
+        }
+        else {
+            btb_out.btb_valid = false;
+        }
+
+        if (pd.branch) {
+            speculate(pc, btb_out.btb_valid);
+        }
+    }
+
+    // Shift the predicted direction of a branch in the speculative history,
+    // also for the branches replayed by the loop buffer of fetch
+    void speculate(ac_int < PC_LEN, false > pc, bool taken) {
+        dir_pred.speculate(taken);
+        #ifdef LOOP_PREDICTOR
+        loop_pred.speculate(pc.to_uint(), taken);
+        #endif
+    }
+
+    void btb_write (fe_in_t fetch_in) {
+        ac_int < PC_LEN, false > update_pc = fetch_in.pc;
+
+        if (fetch_in.btb_update) {
+            ac_int < BTB_INDEX_WIDTH, false > btb_index = update_pc.slc<BTB_INDEX_WIDTH>(2);
+            ac_int < BTB_TAG_WIDTH, false > btb_tag = update_pc.slc<BTB_TAG_WIDTH>(BTB_INDEX_WIDTH + 2);
+            ac_int < BTB_L0_INDEX_WIDTH, false > entry = 0;
+            ac_int < BTB_WAYS_WIDTH, false > btb_way = 0;
+
+            bool l0_hit = btb_l0_find(update_pc, entry);
+            bool l1_hit = btb_l1_find(update_pc, btb_way);
+            bool btb_hit = l0_hit ? (btb_l0_bta[entry] == fetch_in.bta) : (l1_hit && btb_data[btb_index][btb_way].bta == fetch_in.bta);
+            // Counted against the next pc predicted at fetch, which execute
+            // checked. Predicting again here would see the tables trained
+            // since then.
+            if (!fetch_in.redirect) {
+                correct_predictions++;
+            }else {
+                mispredictions++;
+            }
+
+            // Only taken branches are allocated, the others are predicted
+            // not taken by missing in the BTB
+            if (fetch_in.branch_taken && !btb_hit) {
+                if (l0_hit) {
+                    btb_l0_bta[entry] = fetch_in.bta;
+                }
+                if (!l1_hit) {
+                    bool invalid_found = false;
+                    #pragma unroll yes
+                    for (int i = 0; i < BTB_WAYS; i++) {
+                        if (!btb_data[btb_index][i].valid && !invalid_found) {
+                            btb_way = i;
+                            invalid_found = true;
+                        }
+                    }
+                    if (!invalid_found) {
+                        btb_way = btb_repl[btb_index].victim();
+                    }
+                    btb_repl[btb_index].insert(btb_way);
+                }
+                btb_data[btb_index][btb_way].tag = btb_tag;
+                btb_data[btb_index][btb_way].bta = fetch_in.bta;
+                btb_data[btb_index][btb_way].valid = true;
+            }
+            dir_pred.update(update_pc.to_uint(), fetch_in.branch_taken);
+            #ifdef LOOP_PREDICTOR
+            loop_pred.update(update_pc.to_uint(), fetch_in.branch_taken, fetch_in.bta < update_pc);
+            #endif
+        }
+
+        #ifdef INDIRECT_PREDICTOR
+        if (fetch_in.ind_update) {
+            #ifndef __SYNTHESIS__
+            if (!fetch_in.redirect) {
+                ind_correct++;
+            }else {
+                ind_wrong++;
+            }
+            #endif
+            ind_pred.update(update_pc.to_uint(), fetch_in.bta.to_uint());
+        }
+        #endif
+    }
+
+    bool direction (ac_int < PC_LEN, false > branch_pc) {
+        bool taken = dir_pred.predict(branch_pc.to_uint());
+        #ifdef LOOP_PREDICTOR
+        if (loop_pred.confident(branch_pc.to_uint())) {
+            taken = loop_pred.predict(branch_pc.to_uint());
+        }
+        #endif
+        return taken;
+    }
+
+    void jal(ac_int < PC_LEN, false > pc, predecode_t pd) {
+        // JAL targets come from the pre-decoded bits, they need no BTB entry
+        if (pd.jal) {
+            btb_out.btb_valid = true;
+            btb_out.bta = pc + sign_extend_jump(pd.imm);
+        }
+    }
+
+    void indirect(ac_int < PC_LEN, false > pc, predecode_t pd) {
+        #ifdef INDIRECT_PREDICTOR
+        dir_pc_t ind_target;
+        if (pd.jalr && !pd.ret && ind_pred.predict(pc.to_uint(), ind_target)) {
+            btb_out.btb_valid = true;
+            btb_out.bta = ind_target.to_uint();
+        }
+        #endif
+    }
+
+    void ras(ac_int < PC_LEN, false > pc, predecode_t pd) {
+
+        btb_out.ras_valid = false;
+        if (pd.ret) {
+            if (ra_stack[ras_top].valid) {
+                btb_out.ras_valid = true;
+                btb_out.bta = ra_stack[ras_top].pc;
+            }
+            ras_top = ras_top - 1;
+        }else if (pd.call) {
+            ras_top = ras_top + 1;
+            ra_stack[ras_top].pc = pc + 4;
+            ra_stack[ras_top].valid = true;
+        }
+    }
+
+    // Restores the top of the stack checkpointed with the mispredicted
+    // instruction, undoing the pushes and pops of the wrong path.
+    void ras_restore(fe_in_t fetch_in) {
+        ras_top = fetch_in.ras_top;
+        ra_stack[ras_top].pc = fetch_in.ras_tos.to_uint();
+    }
+
+    ac_int < PC_LEN, false > sign_extend_jump(ac_int < PREDECODE_IMM_WIDTH, false > imm) {
+        ac_int < PC_LEN, false > ext_imm = imm;
+        if (imm[PREDECODE_IMM_WIDTH - 1] == 1) {
+            ext_imm.set_slc(PREDECODE_IMM_WIDTH, (ac_int < PC_LEN - PREDECODE_IMM_WIDTH, false >) 2047);
+        }
+        return ext_imm;
+    }
+};
+
+#endif
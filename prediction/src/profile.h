@@ -0,0 +1,233 @@
+/*
+	@author VLSI Lab, EE dept., Democritus University of Thrace
+
+	@brief Header file for the per-branch misprediction profile
+
+	@note
+		- Simulation only. The fetch stage records the control transfer
+		  instructions it sends to decode, their executions and directions
+		  as execute resolves them, and the mispredictions with the cycles
+		  lost until the right path is fetched again. Wrong-path
+		  instructions never resolve, so they are not counted.
+
+		- At the end of the simulation the BRANCH_PROFILE_TOP branches with
+		  the most flushed cycles are printed with their disassembly. If the
+		  BRANCH_PROFILE_ELF environment variable names the ELF of the
+		  program, the function that contains each branch is printed too.
+
+*/
+
+#ifndef __PROFILE__H
+#define __PROFILE__H
+
+#ifndef __SYNTHESIS__
+
+#include "defines.h"
+#include "globals.h"
+
+#include <elf.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct branch_profile_entry_t {
+    unsigned int insn;
+    long int executions;
+    long int taken;
+    long int mispredictions;
+    double flushed_cycles;
+
+    branch_profile_entry_t() : insn(0), executions(0), taken(0), mispredictions(0), flushed_cycles(0) {}
+};
+
+struct branch_symbol_t {
+    unsigned int addr;
+    std::string name;
+
+    bool operator < (const branch_symbol_t & other) const {
+        return addr < other.addr;
+    }
+};
+
+struct branch_profile_t {
+    std::map < unsigned int, branch_profile_entry_t > branches;
+
+    // Misprediction waiting for the right path to be fetched
+    bool flush_pending;
+    unsigned int flush_pc;
+    double flush_start;
+
+    branch_profile_t() : flush_pending(false), flush_pc(0), flush_start(0) {}
+
+    // A control transfer instruction sent to decode, kept for the
+    // disassembly
+    void fetched(unsigned int pc, unsigned int insn) {
+        branches[pc].insn = insn;
+    }
+
+    // Execute resolved the instruction at pc
+    void resolved(unsigned int pc, bool taken) {
+        branch_profile_entry_t & entry = branches[pc];
+        entry.executions++;
+        if (taken) {
+            entry.taken++;
+        }
+    }
+
+    // Execute redirected the fetch after the instruction at pc, now is
+    // the time of the redirect.
+    void mispredicted(unsigned int pc, double now) {
+        branches[pc].mispredictions++;
+        flush_pending = true;
+        flush_pc = pc;
+        flush_start = now;
+    }
+
+    // The first instruction of the right path is sent to decode
+    void refetched(double now) {
+        if (flush_pending) {
+            branches[flush_pc].flushed_cycles += now - flush_start;
+            flush_pending = false;
+        }
+    }
+
+    static const char * reg_name(unsigned int reg) {
+        static const char * names[REG_NUM] = {
+            "zero", "ra", "sp", "gp", "tp", "t0", "t1", "t2",
+            "s0", "s1", "a0", "a1", "a2", "a3", "a4", "a5",
+            "a6", "a7", "s2", "s3", "s4", "s5", "s6", "s7",
+            "s8", "s9", "s10", "s11", "t3", "t4", "t5", "t6"
+        };
+        return names[reg % REG_NUM];
+    }
+
+    static std::string disassemble(unsigned int pc, unsigned int insn) {
+        static const char * branch_names[8] = { "beq", "bne", "?", "?", "blt", "bge", "bltu", "bgeu" };
+        unsigned int opcode = (insn >> 2) & 0x1f;
+        unsigned int rd = (insn >> 7) & 0x1f;
+        unsigned int rs1 = (insn >> 15) & 0x1f;
+        unsigned int rs2 = (insn >> 20) & 0x1f;
+        std::ostringstream s;
+
+        if (opcode == OPC_BEQ) {
+            int imm = (((insn >> 31) & 0x1) << 12) | (((insn >> 7) & 0x1) << 11) | (((insn >> 25) & 0x3f) << 5) | (((insn >> 8) & 0xf) << 1);
+            imm = (imm << 19) >> 19;
+            s << branch_names[(insn >> 12) & 0x7] << " " << reg_name(rs1) << "," << reg_name(rs2) << "," << std::hex << pc + imm;
+        }else if (opcode == OPC_JAL) {
+            int imm = (((insn >> 31) & 0x1) << 20) | (((insn >> 12) & 0xff) << 12) | (((insn >> 20) & 0x1) << 11) | (((insn >> 21) & 0x3ff) << 1);
+            imm = (imm << 11) >> 11;
+            s << "jal " << reg_name(rd) << "," << std::hex << pc + imm;
+        }else if (opcode == OPC_JALR) {
+            int imm = ((int) insn) >> 20;
+            s << "jalr " << reg_name(rd) << "," << std::dec << imm << "(" << reg_name(rs1) << ")";
+        }else {
+            s << ".word 0x" << std::hex << std::setw(8) << std::setfill('0') << insn;
+        }
+        return s.str();
+    }
+
+    // Function and data symbols of a 32-bit ELF, sorted by address
+    static std::vector < branch_symbol_t > read_symbols(const char * path) {
+        std::vector < branch_symbol_t > symbols;
+        std::ifstream elf(path, std::ios::binary);
+        Elf32_Ehdr ehdr;
+        if (!elf.read((char *) &ehdr, sizeof(ehdr)) || ehdr.e_ident[EI_MAG0] != ELFMAG0 || ehdr.e_ident[EI_MAG1] != ELFMAG1 ||
+            ehdr.e_ident[EI_MAG2] != ELFMAG2 || ehdr.e_ident[EI_MAG3] != ELFMAG3 || ehdr.e_ident[EI_CLASS] != ELFCLASS32) {
+            std::cerr << "BRANCH PROFILE: " << path << " is not a 32-bit ELF" << std::endl;
+            return symbols;
+        }
+
+        std::vector < Elf32_Shdr > sections(ehdr.e_shnum);
+        elf.seekg(ehdr.e_shoff);
+        elf.read((char *) sections.data(), ehdr.e_shnum * sizeof(Elf32_Shdr));
+
+        for (int i = 0; i < ehdr.e_shnum && elf; i++) {
+            if (sections[i].sh_type != SHT_SYMTAB || sections[i].sh_link >= ehdr.e_shnum) {
+                continue;
+            }
+            const Elf32_Shdr & strtab = sections[sections[i].sh_link];
+            std::vector < char > strings(strtab.sh_size + 1, 0);
+            elf.seekg(strtab.sh_offset);
+            elf.read(strings.data(), strtab.sh_size);
+
+            std::vector < Elf32_Sym > syms(sections[i].sh_size / sizeof(Elf32_Sym));
+            elf.seekg(sections[i].sh_offset);
+            elf.read((char *) syms.data(), syms.size() * sizeof(Elf32_Sym));
+
+            for (size_t j = 0; j < syms.size(); j++) {
+                int type = ELF32_ST_TYPE(syms[j].st_info);
+                if ((type == STT_FUNC || type == STT_NOTYPE) && syms[j].st_name != 0 && syms[j].st_name < strtab.sh_size &&
+                    syms[j].st_shndx != SHN_UNDEF) {
+                    branch_symbol_t symbol;
+                    symbol.addr = syms[j].st_value;
+                    symbol.name = &strings[syms[j].st_name];
+                    symbols.push_back(symbol);
+                }
+            }
+        }
+        std::sort(symbols.begin(), symbols.end());
+        return symbols;
+    }
+
+    static std::string symbolize(const std::vector < branch_symbol_t > & symbols, unsigned int pc) {
+        branch_symbol_t key;
+        key.addr = pc;
+        std::vector < branch_symbol_t >::const_iterator it = std::upper_bound(symbols.begin(), symbols.end(), key);
+        if (it == symbols.begin()) {
+            return "";
+        }
+        --it;
+        std::ostringstream s;
+        s << " <" << it->name << "+0x" << std::hex << pc - it->addr << ">";
+        return s.str();
+    }
+
+    static bool by_cost(const std::pair < unsigned int, branch_profile_entry_t > & a, const std::pair < unsigned int, branch_profile_entry_t > & b) {
+        if (a.second.flushed_cycles != b.second.flushed_cycles) {
+            return a.second.flushed_cycles > b.second.flushed_cycles;
+        }
+        return a.second.mispredictions > b.second.mispredictions;
+    }
+
+    // period is the clock period, in the same unit as the times passed to
+    // mispredicted() and refetched()
+    void report(double period, int top) {
+        std::vector < std::pair < unsigned int, branch_profile_entry_t > > sorted(branches.begin(), branches.end());
+        std::sort(sorted.begin(), sorted.end(), by_cost);
+
+        std::vector < branch_symbol_t > symbols;
+        const char * elf = getenv("BRANCH_PROFILE_ELF");
+        if (elf) {
+            symbols = read_symbols(elf);
+        }
+
+        std::cout << "BRANCH PROFILE: " << std::dec << branches.size() << " static control transfers, top " << top << " by flushed cycles" << std::endl;
+        std::cout << "      pc     execs  taken%  mispred  flushed  instruction" << std::endl;
+        for (int i = 0; i < (int) sorted.size() && i < top; i++) {
+            const branch_profile_entry_t & entry = sorted[i].second;
+            if (entry.mispredictions == 0) {
+                break;
+            }
+            double taken_rate = entry.executions > 0 ? (100.0 * entry.taken) / entry.executions : 0.0;
+            std::cout << std::hex << std::setw(8) << std::setfill(' ') << sorted[i].first
+                << std::dec << std::setw(10) << entry.executions
+                << std::fixed << std::setprecision(1) << std::setw(8) << taken_rate
+                << std::setw(9) << entry.mispredictions
+                << std::setprecision(0) << std::setw(9) << entry.flushed_cycles / period
+                << "  " << disassemble(sorted[i].first, entry.insn) << symbolize(symbols, sorted[i].first) << std::endl;
+        }
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    }
+};
+
+#endif
+
+#endif
@@ -0,0 +1,349 @@
+/*
+	@author VLSI Lab, EE dept., Democritus University of Thrace
+
+	@brief Header file for the register read and issue logic
+
+	@note
+		- Holds the register file, the scoreboard and the hazard checks. It is
+		  a plain class, so the same code runs in the decode stage or, when
+		  DECODE_SPLIT is defined, in the issue stage that follows it.
+
+		- Interface, called in this order once per cycle:
+			forward(fwd)           result of execute, pops of fwd_exe
+			writeback(wb)          result of writeback, pops of feed_from_wb
+			release()              frees the scoreboard entry written back
+			read(rs1, rs2, output) reads the operands through the bypass network
+			issue(output, squash, bubble)
+			                       numbers the slot, stalls on hazards, allocates
+			                       a tag to a producer and turns stalled and
+			                       squashed instructions into bubbles
+
+		- With MOVE_ELIMINATION a move (ADDI rd, rs, 0, flagged by decode
+		  in de_out_t::move) whose source is still being computed does not wait for it. rd takes the tag of the
+		  producer of rs, which then writes both registers, and the move
+		  leaves as a bubble without an ALU slot.
+
+*/
+
+#ifndef __REGREAD__H
+#define __REGREAD__H
+
+#include "drim4hls_datatypes.h"
+#include "defines.h"
+#include "globals.h"
+
+#include <mc_connections.h>
+
+struct regread_t {
+    // NB. x0 is included in this regfile so it is not a real hardcoded 0
+    // constant. Decode forces the regwrite signal of every instruction that
+    // writes into x0 to false, so x0 is never written, never pending and
+    // its readers never stall.
+    ac_int < XLEN, false > regfile[REG_NUM];
+    // Scoreboard of the in-flight instructions that are going to overwrite a
+    // register. Every producer gets a free tag, sb_tag holds the tag of the
+    // youngest producer of each register and sb_pending counts the producers
+    // still in flight, so several writes to a register can be in flight.
+    ac_int < TAG_WIDTH, false > sb_tag[REG_NUM];
+    ac_int < SB_COUNT_WIDTH, false > sb_pending[REG_NUM];
+    bool tag_busy[SB_TAGS];
+    ac_int < TAG_WIDTH, false > next_tag;
+    #ifdef MOVE_ELIMINATION
+    // Second destination of a producer, written by an eliminated move
+    bool alias_valid[SB_TAGS];
+    ac_int < REG_ADDR, false > alias_reg[SB_TAGS];
+    bool wb_alias; // The producer written back also writes wb_alias_reg
+    ac_int < REG_ADDR, false > wb_alias_reg;
+    #endif
+
+    // Epoch of the instructions on the right path. Instructions fetched
+    // with an older epoch follow a mispredicted branch and are squashed.
+    ac_int < TAG_WIDTH, false > epoch;
+
+    reg_forward_t fwd; // Contains data from the execute stage
+    mem_out_t feedinput; // Contains data from writeback stage
+    bool wb_write;
+
+    bool forward_success_rs1;
+    bool forward_success_rs2;
+    bool rs1_pending;
+    bool rs2_pending;
+    ac_int < REG_ADDR, false > rs1_addr;
+    ac_int < REG_ADDR, false > rs2_addr;
+
+    // Stalls processor and sends a nop operation to the execute stage
+    bool freeze;
+    bool load_instruction;
+    ac_int < ID_WIDTH, false > load_id; // Issue slot of the bubble the conflict waits for
+    ac_int < ID_WIDTH, false > next_id;
+    ac_int < DCACHE_INDEX_WIDTH, false > last_ldst_index;
+    ac_int < DCACHE_INDEX_WIDTH, false > last_ldst_index_temp;
+    bool last_ldst_valid;
+
+    #ifndef __SYNTHESIS__
+    // Bubbles inserted by the hazard checks
+    bool sb_load[REG_NUM]; // The youngest producer of the register is a load
+    long int load_use_bubbles;
+    long int raw_bubbles;
+    long int ldst_bubbles;
+    long int tag_bubbles;
+    long int moves_eliminated;
+    #endif
+
+    void reset() {
+        // Empty scoreboard. Unlike sc_uint, ac_int is not cleared on
+        // construction and x0 must read 0.
+        for (int i = 0; i < REG_NUM; i++) {
+            regfile[i] = 0;
+            sb_tag[i] = 0;
+            sb_pending[i] = 0;
+        }
+        for (int i = 0; i < SB_TAGS; i++) {
+            tag_busy[i] = false;
+            #ifdef MOVE_ELIMINATION
+            alias_valid[i] = false;
+            alias_reg[i] = 0;
+            #endif
+        }
+        next_tag = 0;
+        #ifdef MOVE_ELIMINATION
+        wb_alias = false;
+        wb_alias_reg = 0;
+        #endif
+        epoch = 0;
+        wb_write = false;
+
+        forward_success_rs1 = false;
+        forward_success_rs2 = false;
+        rs1_pending = false;
+        rs2_pending = false;
+        rs1_addr = 0;
+        rs2_addr = 0;
+
+        freeze = false;
+        load_instruction = false;
+        load_id = 0;
+        next_id = 0;
+        last_ldst_valid = false;
+        last_ldst_index = 0;
+        last_ldst_index_temp = 0;
+
+        #ifndef __SYNTHESIS__
+        for (int i = 0; i < REG_NUM; i++) {
+            sb_load[i] = false;
+        }
+        load_use_bubbles = 0;
+        raw_bubbles = 0;
+        ldst_bubbles = 0;
+        tag_bubbles = 0;
+        moves_eliminated = 0;
+        #endif
+    }
+
+    void forward(reg_forward_t fwd_in) {
+        fwd = fwd_in;
+        if (fwd.redirect) {
+            epoch = fwd.epoch;
+        }
+    }
+
+    void writeback(mem_out_t wb_in) {
+        feedinput = wb_in;
+        if (feedinput.id == load_id && load_instruction) {
+            load_instruction = false;
+        }
+    }
+
+    void release() {
+        wb_write = (feedinput.regwrite == 1); // Actual writeback.
+        if (wb_write) {
+            // The producer left the pipeline, its tag can be reused.
+            sb_pending[feedinput.regfile_address] = sb_pending[feedinput.regfile_address] - 1;
+            tag_busy[feedinput.tag] = false;
+        }
+        #ifdef MOVE_ELIMINATION
+        wb_alias = wb_write && alias_valid[feedinput.tag];
+        wb_alias_reg = alias_reg[feedinput.tag];
+        if (wb_alias) {
+            sb_pending[wb_alias_reg] = sb_pending[wb_alias_reg] - 1;
+            alias_valid[feedinput.tag] = false;
+        }
+        #endif
+    }
+
+    // The producer written back this cycle writes reg
+    bool wb_writes(ac_int < REG_ADDR, false > reg) {
+        bool writes = wb_write && feedinput.regfile_address == reg;
+        #ifdef MOVE_ELIMINATION
+        writes = writes || (wb_alias && wb_alias_reg == reg);
+        #endif
+        return writes;
+    }
+
+    // Bypass network, the youngest producer wins: execute, then writeback,
+    // then the register file.
+    void read(ac_int < REG_ADDR, false > rs1, ac_int < REG_ADDR, false > rs2, de_out_t & output) {
+        rs1_addr = rs1;
+        rs2_addr = rs2;
+        forward_success_rs1 = false;
+        forward_success_rs2 = false;
+
+        rs1_pending = (sb_pending[rs1_addr] != 0);
+        if (!fwd.ldst && fwd.tag == sb_tag[rs1_addr] && rs1_pending) {
+            forward_success_rs1 = true;
+            output.rs1 = fwd.regfile_data;
+        } else if (wb_writes(rs1_addr) && feedinput.tag == sb_tag[rs1_addr]) {
+            // Written back this cycle, the same value the register file
+            // would give if it were written before the read
+            output.rs1 = feedinput.regfile_data;
+        } else {
+            output.rs1 = regfile[rs1_addr];
+        }
+
+        rs2_pending = (sb_pending[rs2_addr] != 0);
+        if (!fwd.ldst && fwd.tag == sb_tag[rs2_addr] && rs2_pending) {
+            forward_success_rs2 = true;
+            output.rs2 = fwd.regfile_data;
+        } else if (wb_writes(rs2_addr) && feedinput.tag == sb_tag[rs2_addr]) {
+            output.rs2 = feedinput.regfile_data;
+        } else {
+            output.rs2 = regfile[rs2_addr];
+        }
+
+        // The register file is written after the operands are read, the
+        // value written in this cycle reaches them through the mux above.
+        if (wb_write) {
+            regfile[feedinput.regfile_address] = feedinput.regfile_data; // Overwrite register.
+        }
+        #ifdef MOVE_ELIMINATION
+        if (wb_alias) {
+            regfile[wb_alias_reg] = feedinput.regfile_data;
+        }
+        #endif
+    }
+
+    void issue(de_out_t & output, bool squash, bool bubble) {
+        bool producer = (output.regwrite[0] == 1);
+
+        // A move waiting for its source takes the tag of the producer of rs,
+        // unless rd has older writes in flight or the producer already has
+        // a second destination
+        bool move = false;
+        #ifdef MOVE_ELIMINATION
+        move = (output.move == 1) && rs1_addr != 0 &&
+            rs1_pending && !forward_success_rs1 && sb_pending[output.dest_reg] == 0 && !alias_valid[sb_tag[rs1_addr]];
+        #endif
+
+        ac_int < XLEN, false > curr_temp_rs2 = 0;
+        if (output.alu_src == ALUSRC_RS2) {
+            curr_temp_rs2 = output.rs2;
+
+        } else if (output.alu_src == ALUSRC_IMM_I) {
+            curr_temp_rs2.set_slc(0, output.imm_u.slc<12>(8));
+            if (output.imm_u[19] == 1) {
+                curr_temp_rs2.set_slc(12, (ac_int < 20, false >) 1048575);
+            }
+        } else if (output.alu_src == ALUSRC_IMM_S) {
+            curr_temp_rs2.set_slc(0, output.dest_reg);
+            curr_temp_rs2.set_slc(5, output.imm_u.slc<7>(13));
+            if (curr_temp_rs2[11] == 1) {
+                curr_temp_rs2.set_slc(12, (ac_int < 20, false >) 1048575);
+            }
+
+        } else {
+            curr_temp_rs2.set_slc(0, (ac_int < 12, false >) 0);
+            curr_temp_rs2.set_slc(12, output.imm_u.slc<20>(0));
+        }
+
+        ac_int < XLEN, false > last_ldst_addr = (output.rs1 + curr_temp_rs2);
+        // Every slot gets an id, bubbles included, writeback returns it
+        output.id = next_id;
+        next_id = next_id + 1;
+        last_ldst_index_temp = last_ldst_addr.slc<DCACHE_INDEX_WIDTH>(2 + DCACHE_OFFSET_WIDTH);
+
+        if ((output.ld != NO_LOAD || output.st != NO_STORE) && (last_ldst_index_temp == last_ldst_index) && last_ldst_valid && !freeze && !squash) {
+            load_instruction = true;
+            load_id = output.id;
+        }
+
+        freeze = false;
+        if (!squash && (load_instruction || (rs1_pending && !forward_success_rs1 && !move) || (rs2_pending && !forward_success_rs2) ||
+            (producer && !move && tag_busy[next_tag]))) {
+            freeze = true;
+        }
+
+        #ifndef __SYNTHESIS__
+        if (freeze) {
+            if (load_instruction) {
+                ldst_bubbles++;
+            }else if ((rs1_pending && !forward_success_rs1 && sb_load[rs1_addr]) || (rs2_pending && !forward_success_rs2 && sb_load[rs2_addr])) {
+                load_use_bubbles++;
+            }else if ((rs1_pending && !forward_success_rs1) || (rs2_pending && !forward_success_rs2)) {
+                raw_bubbles++;
+            }else {
+                tag_bubbles++;
+            }
+        }
+        #endif
+
+        #ifdef MOVE_ELIMINATION
+        if (!freeze && !squash && move) {
+            // rd is written back with rs, the move itself is not issued
+            sb_tag[output.dest_reg] = sb_tag[rs1_addr];
+            sb_pending[output.dest_reg] = 1;
+            alias_valid[sb_tag[rs1_addr]] = true;
+            alias_reg[sb_tag[rs1_addr]] = output.dest_reg;
+            #ifndef __SYNTHESIS__
+            sb_load[output.dest_reg] = sb_load[rs1_addr];
+            moves_eliminated++;
+            #endif
+        }
+        #endif
+
+        if (!freeze && !squash && producer && !move) {
+            // Allocate a tag to the new youngest producer of dest_reg.
+            output.tag = next_tag;
+            sb_tag[output.dest_reg] = next_tag;
+            sb_pending[output.dest_reg] = sb_pending[output.dest_reg] + 1;
+            tag_busy[next_tag] = true;
+            next_tag = next_tag + 1;
+            #ifndef __SYNTHESIS__
+            sb_load[output.dest_reg] = (output.ld != NO_LOAD);
+            #endif
+        }
+
+        // *** Transform instruction into nop when freeze is active
+        if (bubble || freeze || squash || move) {
+            // Bubble.
+            output.regwrite = 0;
+            output.ld = NO_LOAD;
+            output.st = NO_STORE;
+            output.alu_op = ALUOP_NULL;
+            output.predecode = predecode_t();
+        }
+        // Stalled and wrong-path slots are not instructions, they must not
+        // redirect the fetch. The removed nops keep their predicted next pc.
+        if (freeze || squash) {
+            output.next_pc = output.pc + 4;
+        }
+
+        if (output.ld != NO_LOAD || output.st != NO_STORE) {
+            last_ldst_index = last_ldst_index_temp;
+            last_ldst_valid = true;
+        }else {
+            last_ldst_valid = false;
+        }
+    }
+
+    #ifndef __SYNTHESIS__
+    void report() {
+        std::cout << "DECODE BUBBLES: " << std::dec << load_use_bubbles << " load-use, " << raw_bubbles << " other RAW, "
+            << ldst_bubbles << " load/store set conflict, " << tag_bubbles << " scoreboard full" << std::endl;
+        #ifdef MOVE_ELIMINATION
+        std::cout << "MOVES ELIMINATED: " << std::dec << moves_eliminated << std::endl;
+        #endif
+    }
+    #endif
+};
+
+#endif
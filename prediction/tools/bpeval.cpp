@@ -0,0 +1,194 @@
+/*
+	@author VLSI Lab, EE dept., Democritus University of Thrace
+
+	@brief Trace-driven evaluator of the branch predictor
+
+	@note
+		- Replays a branch trace through branch_pred_t, the same predictor
+		  code that is synthesized in the fetch stage, without elaborating
+		  any module or starting the SystemC kernel.
+
+		- Every trace line holds one control transfer instruction:
+			<pc> <target> <taken> <type> [<instructions>]
+		  pc and target are hexadecimal, target is the taken target also
+		  for not taken branches. taken is 0 or 1. type is one of
+			b      conditional branch
+			j      JAL that is not a call
+			jr     JALR that is neither a call nor a return
+			call   JAL that writes x1/x5
+			callr  JALR that writes x1/x5
+			ret    JALR that reads x1/x5 and does not write one
+		  instructions is the number of instructions retired since the
+		  previous line, including this one (1 if omitted). Lines starting
+		  with '#' are skipped.
+
+		- The predictor is configured by defines.h. The guarded sizes can be
+		  overridden at compile time, see the bpeval target of the Makefile.
+
+*/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <ctime>
+#include <cstdlib>
+
+#include "drim4hls_datatypes.h"
+#include "defines.h"
+#include "globals.h"
+#include "predictor.h"
+
+#define TYPE_BRANCH 0
+#define TYPE_JUMP 1
+#define TYPE_INDIRECT 2
+#define TYPE_RETURN 3
+#define TYPE_NUM 4
+
+struct bpeval_stats_t {
+    long int instructions;
+    long int records;
+    long int executed[TYPE_NUM];
+    long int mispredicted[TYPE_NUM];
+};
+
+// Pre-decoded bits of a trace record, as the I$ refill would compute them
+bool trace_predecode(const std::string & type, ac_int < PC_LEN, false > pc, ac_int < PC_LEN, false > target, predecode_t & pd) {
+    pd.branch = (type == "b");
+    pd.jal = (type == "j" || type == "call");
+    pd.jalr = (type == "jr" || type == "callr" || type == "ret");
+    pd.call = (type == "call" || type == "callr");
+    pd.ret = (type == "ret");
+    pd.ldst = false;
+    pd.multicycle = false;
+    ac_int < PC_LEN, false > offset = target - pc;
+    pd.imm = offset.slc<PREDECODE_IMM_WIDTH>(0);
+
+    return pd.branch || pd.jal || pd.jalr;
+}
+
+int record_type(predecode_t pd) {
+    if (pd.branch) {
+        return TYPE_BRANCH;
+    }else if (pd.jal) {
+        return TYPE_JUMP;
+    }else if (pd.ret) {
+        return TYPE_RETURN;
+    }
+    return TYPE_INDIRECT;
+}
+
+bool replay(const char * trace, branch_pred_t & bp, bpeval_stats_t & stats) {
+    std::ifstream in(trace);
+    if (!in) {
+        std::cerr << "bpeval: cannot open " << trace << std::endl;
+        return false;
+    }
+
+    std::string line;
+    long int line_number = 0;
+    while (std::getline(in, line)) {
+        line_number++;
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        std::string pc_field, target_field, type;
+        int taken = 0;
+        long int instructions = 1;
+        if (!(fields >> pc_field >> target_field >> taken >> type)) {
+            std::cerr << "bpeval: " << trace << ":" << line_number << ": malformed record" << std::endl;
+            return false;
+        }
+        fields >> instructions;
+
+        ac_int < PC_LEN, false > pc = (unsigned int) strtoul(pc_field.c_str(), NULL, 16);
+        ac_int < PC_LEN, false > target = (unsigned int) strtoul(target_field.c_str(), NULL, 16);
+        predecode_t pd;
+        if (!trace_predecode(type, pc, target, pd)) {
+            std::cerr << "bpeval: " << trace << ":" << line_number << ": unknown type " << type << std::endl;
+            return false;
+        }
+        bool branch_taken = pd.branch ? (taken != 0) : true;
+
+        // Fetch: next pc predicted for the instruction
+        btb_out_t btb_out = bp.predict(pc, pd);
+        ac_int < PC_LEN, false > predicted_pc = (btb_out.btb_valid || btb_out.ras_valid) ? btb_out.bta : (ac_int < PC_LEN, false >)(pc + 4);
+        ac_int < PC_LEN, false > next_pc = branch_taken ? target : (ac_int < PC_LEN, false >)(pc + 4);
+
+        // Decode: resolved instruction sent back to the fetch
+        fe_in_t fetch_in;
+        fetch_in.redirect = (predicted_pc != next_pc);
+        fetch_in.pc = pc;
+        fetch_in.bta = target;
+        fetch_in.branch_taken = pd.branch && branch_taken;
+        fetch_in.btb_update = pd.branch;
+        fetch_in.ind_update = pd.jalr && !pd.ret;
+        fetch_in.ras_top = bp.ras_top;
+        fetch_in.ras_tos = bp.ra_stack[bp.ras_top].pc.to_uint();
+        bp.btb_write(fetch_in);
+
+        int t = record_type(pd);
+        stats.records++;
+        stats.instructions += instructions;
+        stats.executed[t]++;
+        if (fetch_in.redirect) {
+            stats.mispredicted[t]++;
+            bp.repair(fetch_in);
+        }
+    }
+    return true;
+}
+
+double mpki(long int mispredicted, long int instructions) {
+    return instructions > 0 ? (1000.0 * mispredicted) / instructions : 0.0;
+}
+
+int sc_main(int argc, char * argv[]) {
+
+    if (argc == 1) {
+        std::cerr << "Usage: " << argv[0] << " <trace> [<trace> ...]" << std::endl;
+        std::cerr << "where:  <trace> - path to a branch trace, see prediction/tools/bpeval.cpp" << std::endl;
+        return -1;
+    }
+
+    std::cout << "CONFIG: BTB " << BTB_ENTRIES << "x" << BTB_WAYS << " tag " << BTB_TAG_WIDTH << " L0 " << BTB_L0_ENTRIES
+        << ", DIR_PRED_POLICY " << DIR_PRED_POLICY << " entries " << DIR_PRED_ENTRIES << " history " << DIR_PRED_HISTORY_WIDTH
+        << ", counters " << BTB_PREDICTION_BITS_WIDTH << " bits, RAS " << RAS_ENTRIES;
+    #ifdef LOOP_PREDICTOR
+    std::cout << ", loop " << LOOP_PRED_ENTRIES;
+    #endif
+    #ifdef INDIRECT_PREDICTOR
+    std::cout << ", indirect " << IND_PRED_ENTRIES;
+    #endif
+    std::cout << std::endl;
+
+    const char * type_names[TYPE_NUM] = { "branch", "jump", "indirect", "return" };
+    static branch_pred_t bp;
+    int status = 0;
+    for (int i = 1; i < argc; i++) {
+        // Every trace starts from a cold predictor
+        bp.reset();
+        bpeval_stats_t stats = {};
+
+        clock_t start = clock();
+        if (!replay(argv[i], bp, stats)) {
+            status = 1;
+            continue;
+        }
+        double seconds = double(clock() - start) / CLOCKS_PER_SEC;
+
+        long int mispredicted = 0;
+        for (int t = 0; t < TYPE_NUM; t++) {
+            mispredicted += stats.mispredicted[t];
+        }
+        std::cout << argv[i] << ": " << stats.instructions << " instructions, " << stats.records << " control transfers, "
+            << mispredicted << " mispredicted, MPKI " << mpki(mispredicted, stats.instructions) << " (" << seconds << " s)" << std::endl;
+        for (int t = 0; t < TYPE_NUM; t++) {
+            std::cout << "    " << type_names[t] << ": " << stats.mispredicted[t] << "/" << stats.executed[t]
+                << " mispredicted, MPKI " << mpki(stats.mispredicted[t], stats.instructions) << std::endl;
+        }
+    }
+    return status;
+}